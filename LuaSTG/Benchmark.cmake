@@ -0,0 +1,46 @@
+# LuaSTG Benchmark
+# GameObjectPool benchmark, uses the same engine sources and configuration as LuaSTG, except the entry point
+
+add_executable(LuaSTGBenchmark)
+
+luastg_target_common_options(LuaSTGBenchmark)
+target_precompile_headers(LuaSTGBenchmark PRIVATE
+    LuaSTG/SharedHeaders.h
+)
+
+# include directories and definitions, including those added by the custom build configuration
+get_target_property(_LuaSTGBenchmark_include_dirs LuaSTG INCLUDE_DIRECTORIES)
+get_target_property(_LuaSTGBenchmark_definitions LuaSTG COMPILE_DEFINITIONS)
+target_include_directories(LuaSTGBenchmark PRIVATE
+    ${_LuaSTGBenchmark_include_dirs}
+)
+target_compile_definitions(LuaSTGBenchmark PRIVATE
+    ${_LuaSTGBenchmark_definitions}
+    LUASTG_BENCHMARK
+)
+
+set(_LuaSTGBenchmark_sources ${LUASTG_ENGINE_SOURCES})
+list(REMOVE_ITEM _LuaSTGBenchmark_sources
+    LuaSTG/Main.cpp
+    LuaSTG/LuaSTG.manifest
+)
+set(_LuaSTGBenchmark_custom_sources ${_LuaSTG_res})
+list(FILTER _LuaSTGBenchmark_custom_sources INCLUDE REGEX "\\.(cpp|h)$")
+
+set(LUASTG_BENCHMARK_SOURCES
+    LuaSTG/Benchmark/GameObjectPoolBenchmark.cpp
+)
+
+source_group(TREE ${CMAKE_CURRENT_LIST_DIR} FILES ${LUASTG_BENCHMARK_SOURCES})
+target_sources(LuaSTGBenchmark PRIVATE
+    ${_LuaSTGBenchmark_sources}
+    ${_LuaSTGBenchmark_custom_sources}
+    ${LUASTG_BENCHMARK_SOURCES}
+)
+
+# the benchmark has its own main function
+get_target_property(_LuaSTGBenchmark_libraries LuaSTG LINK_LIBRARIES)
+list(REMOVE_ITEM _LuaSTGBenchmark_libraries SDL2main)
+target_link_libraries(LuaSTGBenchmark PRIVATE
+    ${_LuaSTGBenchmark_libraries}
+)
@@ -34,17 +34,25 @@ set(Core_SRC
     Core/Graphics/Window.hpp
     Core/Graphics/Window_SDL.hpp
     Core/Graphics/Window_SDL.cpp
+    Core/Graphics/Window_Null.hpp
+    Core/Graphics/Window_Null.cpp
     Core/Graphics/Format.hpp
     Core/Graphics/Device.hpp
     Core/Graphics/Device_OpenGL.hpp
     Core/Graphics/Device_OpenGL.cpp
+    Core/Graphics/Device_Null.hpp
+    Core/Graphics/Device_Null.cpp
     Core/Graphics/SwapChain.hpp
     Core/Graphics/SwapChain_OpenGL.hpp
     Core/Graphics/SwapChain_OpenGL.cpp
+    Core/Graphics/SwapChain_Null.hpp
+    Core/Graphics/SwapChain_Null.cpp
     Core/Graphics/Renderer.hpp
     Core/Graphics/Renderer_OpenGL.hpp
     Core/Graphics/Renderer_OpenGL.cpp
     Core/Graphics/Renderer_Shader_OpenGL.cpp
+    Core/Graphics/Renderer_Null.hpp
+    Core/Graphics/Renderer_Null.cpp
     Core/Graphics/Model_OpenGL.hpp
     Core/Graphics/Model_OpenGL.cpp
     Core/Graphics/Model_Shader_OpenGL.cpp
@@ -58,6 +66,8 @@ set(Core_SRC
     Core/ApplicationModel.hpp
     Core/ApplicationModel_SDL.hpp
     Core/ApplicationModel_SDL.cpp
+    Core/ApplicationModel_Null.hpp
+    Core/ApplicationModel_Null.cpp
     Core/EventDispatcherImpl.hpp
 
     Core/Audio/Decoder.hpp
@@ -67,6 +77,8 @@ set(Core_SRC
     Core/Audio/Device.hpp
     Core/Audio/Device_SDL.cpp
     Core/Audio/Device_SDL.hpp
+    Core/Audio/Device_Null.cpp
+    Core/Audio/Device_Null.hpp
 )
 source_group(TREE ${CMAKE_CURRENT_LIST_DIR} FILES ${Core_SRC})
 target_precompile_headers(Core PRIVATE
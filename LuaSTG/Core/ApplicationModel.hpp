@@ -61,12 +61,16 @@ namespace Core
         virtual FrameStatistics getFrameStatistics() = 0;
         // [Work Thread]
         virtual FrameRenderStatistics getFrameRenderStatistics() = 0;
+        // [Work Thread] 所有已完成帧的累计耗时
+        virtual FrameStatistics getTotalFrameStatistics() = 0;
+        // [Main thread | Work Thread] 无窗口模式：窗口、图形设备和音频设备都是空实现，不渲染、不限制帧率
+        virtual bool isHeadless() = 0;
 
         // [Main thread | Work Thread]
         virtual void requestExit() = 0;
         // [Main thread ]
         virtual bool run() = 0;
 
-        static bool create(IApplicationEventListener* p_app, IApplicationModel** pp_model);
+        static bool create(IApplicationEventListener* p_app, IApplicationModel** pp_model, bool headless = false);
     };
 }
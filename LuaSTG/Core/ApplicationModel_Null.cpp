@@ -0,0 +1,71 @@
+﻿#include "Core/ApplicationModel_Null.hpp"
+#include "spdlog/spdlog.h"
+#include <stdexcept>
+
+namespace Core
+{
+	double FrameRateController_Null::update()
+	{
+		TimePoint const curr = Clock::now();
+		double const s = std::chrono::duration_cast<Duration>(curr - last_).count();
+		last_ = curr;
+		total_frame_ += 1;
+		total_time_ += s;
+		fps_ = s > 0.0 ? 1.0 / s : 0.0;
+		return s;
+	}
+
+	FrameRateController_Null::FrameRateController_Null()
+	{
+		last_ = Clock::now();
+	}
+}
+
+namespace Core
+{
+	bool ApplicationModel_Null::run()
+	{
+		using Duration = std::chrono::duration<double>;
+		using Clock = std::chrono::high_resolution_clock;
+
+		if (!m_listener)
+			return false;
+
+		m_frame_rate_controller.update();
+		while (!m_exit_flag)
+		{
+			// 没有渲染和呈现，也不等待，一帧的耗时就是逻辑更新的耗时
+			auto const start = Clock::now();
+			m_listener->onUpdate();
+			auto const end = Clock::now();
+			m_frame_rate_controller.update();
+
+			m_framestate = FrameStatistics{};
+			m_framestate.update_time = Duration(end - start).count();
+			m_framestate.total_time = Duration(Clock::now() - start).count();
+			m_framestate_total.total_time += m_framestate.total_time;
+			m_framestate_total.update_time += m_framestate.update_time;
+		}
+
+		return true;
+	}
+
+	ApplicationModel_Null::ApplicationModel_Null(IApplicationEventListener* p_listener)
+		: m_listener(p_listener)
+	{
+		spdlog::info("[core] Headless mode, using null window, graphics device and audio device");
+		if (!Graphics::Window_Null::create(~m_window))
+			throw std::runtime_error("Graphics::Window_Null::create");
+		if (!Graphics::Device_Null::create(~m_device))
+			throw std::runtime_error("Graphics::Device_Null::create");
+		if (!Graphics::SwapChain_Null::create(*m_window, ~m_swapchain))
+			throw std::runtime_error("Graphics::SwapChain_Null::create");
+		if (!Graphics::Renderer_Null::create(~m_renderer))
+			throw std::runtime_error("Graphics::Renderer_Null::create");
+		if (!Audio::Device_Null::create(~m_audiosys))
+			throw std::runtime_error("Audio::Device_Null::create");
+	}
+	ApplicationModel_Null::~ApplicationModel_Null()
+	{
+	}
+}
@@ -0,0 +1,79 @@
+﻿#pragma once
+#include "Core/Object.hpp"
+#include "Core/ApplicationModel.hpp"
+#include "Core/Graphics/Window_Null.hpp"
+#include "Core/Graphics/Device_Null.hpp"
+#include "Core/Graphics/SwapChain_Null.hpp"
+#include "Core/Graphics/Renderer_Null.hpp"
+#include "Core/Audio/Device_Null.hpp"
+#include <chrono>
+
+namespace Core
+{
+	// 无窗口模式使用的应用模型：不初始化 SDL，窗口、图形设备、交换链、渲染器和音频设备都是空实现，
+	// 只循环调用逻辑更新，不渲染、不等待
+
+	class FrameRateController_Null : public IFrameRateController
+	{
+	private:
+		using Duration = std::chrono::duration<double>;
+		using Clock = std::chrono::high_resolution_clock;
+		using TimePoint = std::chrono::time_point<Clock>;
+	private:
+		TimePoint last_{};
+		uint64_t total_frame_{};
+		double total_time_{};
+		double target_fps_{ 60.0 };
+		double fps_{};
+	public:
+		double update();
+		uint32_t getTargetFPS() { return (uint32_t)target_fps_; }
+		void setTargetFPS(uint32_t target_FPS) { target_fps_ = (double)(target_FPS > 0 ? target_FPS : 1); }
+		double getFPS() { return fps_; }
+		uint64_t getTotalFrame() { return total_frame_; }
+		double getTotalTime() { return total_time_; }
+		double getAvgFPS() { return total_time_ > 0.0 ? (double)total_frame_ / total_time_ : 0.0; }
+		double getMinFPS() { return fps_; }
+		double getMaxFPS() { return fps_; }
+	public:
+		FrameRateController_Null();
+	};
+
+	class ApplicationModel_Null : public Object<IApplicationModel>
+	{
+	private:
+		ScopeObject<Graphics::Window_Null> m_window;
+		ScopeObject<Graphics::Device_Null> m_device;
+		ScopeObject<Graphics::SwapChain_Null> m_swapchain;
+		ScopeObject<Graphics::Renderer_Null> m_renderer;
+		ScopeObject<Audio::Device_Null> m_audiosys;
+		FrameRateController_Null m_frame_rate_controller;
+		IApplicationEventListener* m_listener{ nullptr };
+		FrameStatistics m_framestate{};
+		FrameStatistics m_framestate_total{};
+		bool m_exit_flag{};
+
+	public:
+		Graphics::Renderer_Null* getNullRenderer() { return *m_renderer; }
+
+	public:
+		IFrameRateController* getFrameRateController() { return &m_frame_rate_controller; };
+		Graphics::IWindow* getWindow() { return *m_window; }
+		Graphics::IDevice* getDevice() { return *m_device; }
+		Graphics::ISwapChain* getSwapChain() { return *m_swapchain; }
+		Graphics::IRenderer* getRenderer() { return *m_renderer; }
+		Audio::IAudioDevice* getAudioDevice() { return m_audiosys.get(); }
+		FrameStatistics getFrameStatistics() { return m_framestate; }
+		FrameRenderStatistics getFrameRenderStatistics() { return {}; }
+		FrameStatistics getTotalFrameStatistics() { return m_framestate_total; }
+		bool isHeadless() { return true; }
+
+		void requestExit() { m_exit_flag = true; }
+		bool run();
+
+	public:
+		// 监听器可以为空，此时只提供设备和渲染器（基准测试直接驱动对象池，不调用 run）
+		explicit ApplicationModel_Null(IApplicationEventListener* p_listener);
+		~ApplicationModel_Null();
+	};
+}
@@ -1,5 +1,6 @@
 ﻿#include "Core/ApplicationModel_SDL.hpp"
 #include "Core/ApplicationModel.hpp"
+#include "Core/ApplicationModel_Null.hpp"
 // #include "Core/i18n.hpp"
 // #include "Platform/WindowsVersion.hpp"
 // #include "Platform/DetectCPU.hpp"
@@ -254,6 +255,7 @@ namespace Core
 		while (!m_exit_flag)
 		{
 			runFrame();
+			accumulateFrameStatistics();
 		}
 
 		return true;
@@ -314,6 +316,15 @@ namespace Core
 		// m_frame_query_index = next_frame_query_index;
 		FrameMark;
 	}
+	void ApplicationModel_SDL::accumulateFrameStatistics()
+	{
+		FrameStatistics const& d = m_framestate[m_framestate_index];
+		m_framestate_total.total_time += d.total_time;
+		m_framestate_total.wait_time += d.wait_time;
+		m_framestate_total.update_time += d.update_time;
+		m_framestate_total.render_time += d.render_time;
+		m_framestate_total.present_time += d.present_time;
+	}
 
 	FrameStatistics ApplicationModel_SDL::getFrameStatistics()
 	{
@@ -375,11 +386,14 @@ namespace Core
 		std::ignore = 0;
 	}
 
-	bool IApplicationModel::create(IApplicationEventListener* p_app, IApplicationModel** pp_model)
+	bool IApplicationModel::create(IApplicationEventListener* p_app, IApplicationModel** pp_model, bool headless)
 	{
 		try
 		{
-			*pp_model = new ApplicationModel_SDL(p_app);
+			if (headless)
+				*pp_model = new ApplicationModel_Null(p_app);
+			else
+				*pp_model = new ApplicationModel_SDL(p_app);
 			return true;
 		}
 		catch (...)
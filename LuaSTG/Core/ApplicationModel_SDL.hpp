@@ -69,8 +69,10 @@ namespace Core
 		IApplicationEventListener* m_listener{ nullptr };
 		size_t m_framestate_index{ 0 };
 		FrameStatistics m_framestate[2]{};
+		FrameStatistics m_framestate_total{};
 
 		bool runSingleThread();
+		void accumulateFrameStatistics();
 
 	public:
 		// Internal Public
@@ -92,6 +94,8 @@ namespace Core
 		Audio::IAudioDevice* getAudioDevice() { return m_audiosys.get(); }
 		FrameStatistics getFrameStatistics();
 		FrameRenderStatistics getFrameRenderStatistics();
+		FrameStatistics getTotalFrameStatistics() { return m_framestate_total; }
+		bool isHeadless() { return false; }
 
 		// Main thread exclusive
 
@@ -0,0 +1,96 @@
+﻿#include "Core/Audio/Device_Null.hpp"
+#include "spdlog/spdlog.h"
+#include <cassert>
+
+namespace Core::Audio
+{
+	void Device_Null::setVolume(float v)
+	{
+		setMixChannelVolume(MixChannel::Direct, v);
+	}
+	float Device_Null::getVolume()
+	{
+		return getMixChannelVolume(MixChannel::Direct);
+	}
+	void Device_Null::setMixChannelVolume(MixChannel ch, float v)
+	{
+		switch (ch)
+		{
+		case MixChannel::Direct:
+			m_volume_direct = v;
+			break;
+		case MixChannel::SoundEffect:
+			m_volume_sound_effect = v;
+			break;
+		case MixChannel::Music:
+			m_volume_music = v;
+			break;
+		default:
+			assert(false);
+			break;
+		}
+	}
+	float Device_Null::getMixChannelVolume(MixChannel ch)
+	{
+		switch (ch)
+		{
+		case MixChannel::Direct: return m_volume_direct;
+		case MixChannel::SoundEffect: return m_volume_sound_effect;
+		case MixChannel::Music: return m_volume_music;
+		default: assert(false); return 1.0f;
+		}
+	}
+
+	bool Device_Null::createAudioPlayer(IDecoder* p_decoder, IAudioPlayer** pp_player)
+	{
+		try
+		{
+			*pp_player = new AudioPlayer_Null(p_decoder);
+			return true;
+		}
+		catch (...)
+		{
+			*pp_player = nullptr;
+			return false;
+		}
+	}
+	bool Device_Null::createLoopAudioPlayer(IDecoder* p_decoder, IAudioPlayer** pp_player)
+	{
+		return createAudioPlayer(p_decoder, pp_player);
+	}
+	bool Device_Null::createStreamAudioPlayer(IDecoder* p_decoder, IAudioPlayer** pp_player)
+	{
+		return createAudioPlayer(p_decoder, pp_player);
+	}
+
+	Device_Null::Device_Null()
+	{
+		spdlog::info("[core] created Null Audio Device");
+	}
+	Device_Null::~Device_Null()
+	{
+	}
+
+	bool Device_Null::create(Device_Null** pp_audio)
+	{
+		try
+		{
+			*pp_audio = new Device_Null();
+			return true;
+		}
+		catch (...)
+		{
+			*pp_audio = nullptr;
+			return false;
+		}
+	}
+
+	AudioPlayer_Null::AudioPlayer_Null(IDecoder* p_decoder)
+	{
+		// 只用解码器读取时长，不解码音频数据
+		if (p_decoder && p_decoder->getSampleRate() > 0)
+		{
+			m_total_time = (double)p_decoder->getFrameCount() / (double)p_decoder->getSampleRate();
+		}
+	}
+}
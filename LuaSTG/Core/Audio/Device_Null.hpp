@@ -0,0 +1,84 @@
+﻿#pragma once
+#include "Core/Audio/Decoder.hpp"
+#include "Core/Object.hpp"
+#include "Core/Audio/Device.hpp"
+#include <cstdint>
+
+namespace Core::Audio
+{
+	// 无窗口模式使用的空音频设备：不打开系统音频设备，也不解码音频数据；
+	// 播放器只记录播放状态和参数，播放位置不会前进，开始播放后一直处于播放状态直到被停止
+
+	class Device_Null : public Object<IAudioDevice>
+	{
+	private:
+		float m_volume_direct = 1.0f;
+		float m_volume_sound_effect = 1.0f;
+		float m_volume_music = 1.0f;
+
+	public:
+		uint32_t getAudioDeviceCount(bool) { return 0; }
+		std::string_view getAudioDeviceName(uint32_t) const noexcept { return ""; }
+		bool setTargetAudioDevice(std::string_view const) { return true; }
+		std::string_view getCurrentAudioDeviceName() const noexcept { return ""; }
+
+		void setVolume(float v);
+		float getVolume();
+		void setMixChannelVolume(MixChannel ch, float v);
+		float getMixChannelVolume(MixChannel ch);
+
+		bool createAudioPlayer(IDecoder* p_decoder, IAudioPlayer** pp_player);
+		bool createLoopAudioPlayer(IDecoder* p_decoder, IAudioPlayer** pp_player);
+		bool createStreamAudioPlayer(IDecoder* p_decoder, IAudioPlayer** pp_player);
+
+	public:
+		Device_Null();
+		~Device_Null();
+
+	public:
+		static bool create(Device_Null** pp_audio);
+	};
+
+	class AudioPlayer_Null : public Object<IAudioPlayer>
+	{
+	private:
+		double m_total_time{ 0.0 };
+		double m_current_time{ 0.0 };
+		double m_loop_start{ 0.0 };
+		double m_loop_length{ 0.0 };
+		float m_volume{ 1.0f };
+		float m_balance{ 0.0f };
+		float m_speed{ 1.0f };
+		bool m_is_playing{ false };
+		bool m_is_loop{ false };
+
+	public:
+		bool start() { m_is_playing = true; return true; }
+		bool stop() { m_is_playing = false; return true; }
+		bool reset() { m_is_playing = false; m_current_time = 0.0; return true; }
+
+		bool isPlaying() { return m_is_playing; }
+
+		double getTotalTime() { return m_total_time; }
+		double getTime() { return m_current_time; }
+		bool setTime(double t) { m_current_time = t; return true; }
+		bool getLoop() { return m_is_loop; }
+		void getLoopRange(double& start_pos, double& length) { start_pos = m_loop_start; length = m_loop_length; }
+		bool setLoop(bool enable) { m_is_loop = enable; return true; }
+		bool setLoopRange(double start_pos, double length) { m_loop_start = start_pos; m_loop_length = length; return true; }
+
+		float getVolume() { return m_volume; }
+		bool setVolume(float v) { m_volume = v; return true; }
+		float getBalance() { return m_balance; }
+		bool setBalance(float v) { m_balance = v; return true; }
+		float getSpeed() { return m_speed; }
+		bool setSpeed(float v) { m_speed = v; return true; }
+
+		void updateFFT() {}
+		uint32_t getFFTSize() { return 0; }
+		float* getFFT() { return nullptr; }
+
+	public:
+		explicit AudioPlayer_Null(IDecoder* p_decoder);
+	};
+}
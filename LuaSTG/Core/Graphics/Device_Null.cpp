@@ -0,0 +1,190 @@
+﻿#include "Core/Graphics/Device_Null.hpp"
+#include "Core/FileManager.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "spdlog/spdlog.h"
+#include "stb_image.h"
+
+namespace Core::Graphics
+{
+	// 只读取图片尺寸，和 Texture2D_OpenGL 一样支持 QOI 和 stb_image 支持的格式
+	static bool readImageSize(uint8_t const* data, size_t size, Vector2U& image_size)
+	{
+		if (size >= 14 && data[0] == 'q' && data[1] == 'o' && data[2] == 'i' && data[3] == 'f')
+		{
+			auto const read_u32_be = [](uint8_t const* p) -> uint32_t
+			{
+				return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+			};
+			image_size.x = read_u32_be(data + 4);
+			image_size.y = read_u32_be(data + 8);
+			return image_size.x > 0 && image_size.y > 0;
+		}
+		Vector2I sz;
+		if (!stbi_info_from_memory(data, (int)size, &sz.x, &sz.y, NULL))
+			return false;
+		// image size will never be negative
+		image_size.x = (uint32_t)sz.x;
+		image_size.y = (uint32_t)sz.y;
+		return true;
+	}
+
+	Device_Null::Device_Null()
+	{
+		spdlog::info("[core] created Null Device");
+	}
+	Device_Null::~Device_Null()
+	{
+	}
+
+	bool Device_Null::createTextureFromFile(StringView path, bool mipmap, ITexture2D** pp_texture)
+	{
+		std::ignore = mipmap;
+		*pp_texture = nullptr;
+		std::vector<uint8_t> src;
+		if (!GFileManager().loadEx(path, src))
+		{
+			spdlog::error("[core] Unable to load file '{}'", path);
+			return false;
+		}
+		Vector2U size;
+		if (!readImageSize(src.data(), src.size(), size))
+		{
+			spdlog::error("[core] Unable to parse file '{}'", path);
+			return false;
+		}
+		try
+		{
+			*pp_texture = new Texture2D_Null(size, false);
+			return true;
+		}
+		catch (...)
+		{
+			*pp_texture = nullptr;
+			return false;
+		}
+	}
+	bool Device_Null::createTextureFromMemory(void const* data, size_t size, bool mipmap, ITexture2D** pp_texture)
+	{
+		std::ignore = mipmap;
+		*pp_texture = nullptr;
+		Vector2U image_size;
+		if (!readImageSize(static_cast<uint8_t const*>(data), size, image_size))
+		{
+			spdlog::error("[core] Unable to parse binary data");
+			return false;
+		}
+		try
+		{
+			*pp_texture = new Texture2D_Null(image_size, false);
+			return true;
+		}
+		catch (...)
+		{
+			*pp_texture = nullptr;
+			return false;
+		}
+	}
+	bool Device_Null::createTexture(Vector2U size, ITexture2D** pp_texture)
+	{
+		try
+		{
+			*pp_texture = new Texture2D_Null(size, true);
+			return true;
+		}
+		catch (...)
+		{
+			*pp_texture = nullptr;
+			return false;
+		}
+	}
+
+	bool Device_Null::createRenderTarget(Vector2U size, IRenderTarget** pp_rt)
+	{
+		try
+		{
+			*pp_rt = new RenderTarget_Null(size);
+			return true;
+		}
+		catch (...)
+		{
+			*pp_rt = nullptr;
+			return false;
+		}
+	}
+	bool Device_Null::createDepthStencilBuffer(Vector2U size, IDepthStencilBuffer** pp_ds)
+	{
+		try
+		{
+			*pp_ds = new DepthStencilBuffer_Null(size);
+			return true;
+		}
+		catch (...)
+		{
+			*pp_ds = nullptr;
+			return false;
+		}
+	}
+
+	bool Device_Null::create(Device_Null** p_device)
+	{
+		try
+		{
+			*p_device = new Device_Null();
+			return true;
+		}
+		catch (...)
+		{
+			*p_device = nullptr;
+			return false;
+		}
+	}
+}
+
+namespace Core::Graphics
+{
+	// Texture2D
+
+	bool Texture2D_Null::setSize(Vector2U size)
+	{
+		if (!m_dynamic)
+		{
+			spdlog::error("[core] Cannot modify size of static texture");
+			return false;
+		}
+		m_size = size;
+		return true;
+	}
+
+	bool Texture2D_Null::uploadPixelData(RectU, void const*, uint32_t)
+	{
+		return m_dynamic;
+	}
+
+	Texture2D_Null::Texture2D_Null(Vector2U size, bool dynamic)
+		: m_size(size)
+		, m_dynamic(dynamic)
+	{
+	}
+
+	// RenderTarget
+
+	bool RenderTarget_Null::setSize(Vector2U size)
+	{
+		if (!m_depthstencilbuffer->setSize(size)) return false;
+		if (!m_texture->setSize(size)) return false;
+		return true;
+	}
+
+	RenderTarget_Null::RenderTarget_Null(Vector2U size)
+	{
+		m_texture.attach(new Texture2D_Null(size, true));
+		m_texture->setPremultipliedAlpha(true);
+		m_depthstencilbuffer.attach(new DepthStencilBuffer_Null(size));
+	}
+}
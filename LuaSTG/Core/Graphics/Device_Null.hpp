@@ -0,0 +1,93 @@
+﻿#pragma once
+#include "Core/Object.hpp"
+#include "Core/Graphics/Device.hpp"
+#include "Core/Type.hpp"
+#include <optional>
+
+namespace Core::Graphics
+{
+	// 无窗口模式使用的空设备：不创建图形 API 上下文，纹理只记录尺寸，
+	// 从文件和内存创建纹理时只读取图片头部的尺寸，资源加载的成功与失败和正常设备一致
+
+	class Device_Null : public Object<IDevice>
+	{
+	public:
+		void addEventListener(IDeviceEventListener*) {}
+		void removeEventListener(IDeviceEventListener*) {}
+
+		bool recreate() { return true; }
+
+		void* getNativeHandle() { return nullptr; }
+		void* getNativeRendererHandle() { return nullptr; }
+
+		bool createTextureFromFile(StringView path, bool mipmap, ITexture2D** pp_texutre);
+		bool createTextureFromMemory(void const* data, size_t size, bool mipmap, ITexture2D** pp_texutre);
+		bool createTexture(Vector2U size, ITexture2D** pp_texutre);
+
+		bool createRenderTarget(Vector2U size, IRenderTarget** pp_rt);
+		bool createDepthStencilBuffer(Vector2U size, IDepthStencilBuffer** pp_ds);
+
+	public:
+		Device_Null();
+		~Device_Null();
+
+	public:
+		static bool create(Device_Null** p_device);
+	};
+
+	class Texture2D_Null : public Object<ITexture2D>
+	{
+	private:
+		std::optional<SamplerState> m_sampler;
+		Vector2U m_size;
+		bool m_dynamic{ false };
+		bool m_premul{ false };
+	public:
+		void* getNativeHandle() { return nullptr; }
+
+		bool isDynamic() { return m_dynamic; }
+		bool isPremultipliedAlpha() { return m_premul; }
+		void setPremultipliedAlpha(bool v) { m_premul = v; }
+		Vector2U getSize() { return m_size; }
+		bool setSize(Vector2U size);
+
+		bool uploadPixelData(RectU rc, void const* data, uint32_t pitch);
+		void setPixelData(IData*) {}
+
+		bool saveToFile(StringView) { return false; }
+
+		void setSamplerState(SamplerState sampler) { m_sampler = sampler; }
+		std::optional<SamplerState> getSamplerState() { return m_sampler; }
+	public:
+		Texture2D_Null(Vector2U size, bool dynamic);
+	};
+
+	class DepthStencilBuffer_Null : public Object<IDepthStencilBuffer>
+	{
+	private:
+		Vector2U m_size;
+	public:
+		void* getNativeHandle() { return nullptr; }
+
+		bool setSize(Vector2U size) { m_size = size; return true; }
+		Vector2U getSize() { return m_size; }
+	public:
+		explicit DepthStencilBuffer_Null(Vector2U size) : m_size(size) {}
+	};
+
+	class RenderTarget_Null : public Object<IRenderTarget>
+	{
+	private:
+		ScopeObject<Texture2D_Null> m_texture;
+		ScopeObject<DepthStencilBuffer_Null> m_depthstencilbuffer;
+	public:
+		void* getNativeHandle() { return nullptr; }
+
+		bool DepthStencilBufferEnabled() { return true; }
+
+		bool setSize(Vector2U size);
+		ITexture2D* getTexture() { return *m_texture; }
+	public:
+		explicit RenderTarget_Null(Vector2U size);
+	};
+}
@@ -0,0 +1,148 @@
+﻿#include "Core/Graphics/Renderer_Null.hpp"
+#include "Core/FileManager.hpp"
+#include "spdlog/spdlog.h"
+#include <cstring>
+
+namespace Core::Graphics
+{
+	bool Renderer_Null::flush()
+	{
+		if (m_vertex_count > 0 || m_index_count > 0)
+		{
+			m_stat.flush += 1;
+		}
+		m_vertex_count = 0;
+		m_index_count = 0;
+		return true;
+	}
+	void Renderer_Null::setBlendState(BlendState state)
+	{
+		if (m_blend != state)
+		{
+			flush();
+			m_blend = state;
+			m_stat.blend_switch += 1;
+		}
+	}
+	void Renderer_Null::setTexture(ITexture2D* texture)
+	{
+		if (m_texture != texture)
+		{
+			flush();
+			m_texture = texture;
+			m_stat.texture_switch += 1;
+		}
+	}
+
+	bool Renderer_Null::drawTriangle(DrawVertex const& v1, DrawVertex const& v2, DrawVertex const& v3)
+	{
+		DrawVertex const vert[3] = { v1, v2, v3 };
+		return drawTriangle(vert);
+	}
+	bool Renderer_Null::drawTriangle(DrawVertex const* pvert)
+	{
+		DrawIndex const idx[3] = { 0, 1, 2 };
+		return drawRaw(pvert, 3, idx, 3);
+	}
+	bool Renderer_Null::drawQuad(DrawVertex const& v1, DrawVertex const& v2, DrawVertex const& v3, DrawVertex const& v4)
+	{
+		DrawVertex const vert[4] = { v1, v2, v3, v4 };
+		return drawQuad(vert);
+	}
+	bool Renderer_Null::drawQuad(DrawVertex const* pvert)
+	{
+		DrawIndex const idx[6] = { 0, 1, 2, 0, 2, 3 };
+		return drawRaw(pvert, 4, idx, 6);
+	}
+	bool Renderer_Null::drawRaw(DrawVertex const* pvert, uint16_t nvert, DrawIndex const* pidx, uint16_t nidx)
+	{
+		DrawVertex* vert = nullptr;
+		DrawIndex* index = nullptr;
+		uint16_t offset = 0;
+		if (!drawRequest(nvert, nidx, &vert, &index, &offset))
+			return false;
+		std::memcpy(vert, pvert, sizeof(DrawVertex) * nvert);
+		for (uint16_t i = 0; i < nidx; i += 1)
+			index[i] = (DrawIndex)(offset + pidx[i]);
+		return true;
+	}
+	bool Renderer_Null::drawRequest(uint16_t nvert, uint16_t nidx, DrawVertex** ppvert, DrawIndex** ppidx, uint16_t* idxoffset)
+	{
+		if (nvert > VERTEX_BUFFER_SIZE || nidx > INDEX_BUFFER_SIZE)
+			return false;
+		// 序号是 16 位的，和 OpenGL 渲染器一样在写满前提交
+		if ((m_vertex_count + nvert) > VERTEX_BUFFER_SIZE || (m_index_count + nidx) > INDEX_BUFFER_SIZE)
+			flush();
+		*ppvert = m_vertex.data() + m_vertex_count;
+		*ppidx = m_index.data() + m_index_count;
+		*idxoffset = (uint16_t)m_vertex_count;
+		m_vertex_count += nvert;
+		m_index_count += nidx;
+		m_stat.vertex += nvert;
+		m_stat.index += nidx;
+		return true;
+	}
+
+	// 不编译着色器、不解析模型，只检查文件是否存在，保证资源加载的成功与失败和正常渲染器一致
+
+	bool Renderer_Null::createPostEffectShader(StringView path, IPostEffectShader** pp_effect)
+	{
+		*pp_effect = nullptr;
+		if (!GFileManager().containEx(path))
+		{
+			spdlog::error("[core] Unable to load file '{}'", path);
+			return false;
+		}
+		try
+		{
+			*pp_effect = new PostEffectShader_Null();
+			return true;
+		}
+		catch (...)
+		{
+			return false;
+		}
+	}
+	bool Renderer_Null::createModel(StringView path, IModel** pp_model)
+	{
+		*pp_model = nullptr;
+		if (!GFileManager().containEx(path))
+		{
+			spdlog::error("[core] Unable to load file '{}'", path);
+			return false;
+		}
+		try
+		{
+			*pp_model = new Model_Null();
+			return true;
+		}
+		catch (...)
+		{
+			return false;
+		}
+	}
+
+	Renderer_Null::Renderer_Null()
+		: m_vertex(VERTEX_BUFFER_SIZE)
+		, m_index(INDEX_BUFFER_SIZE)
+	{
+		spdlog::info("[core] created Null Renderer");
+	}
+	Renderer_Null::~Renderer_Null()
+	{
+	}
+
+	bool Renderer_Null::create(Renderer_Null** pp_renderer)
+	{
+		try
+		{
+			*pp_renderer = new Renderer_Null();
+			return true;
+		}
+		catch (...)
+		{
+			*pp_renderer = nullptr;
+			return false;
+		}
+	}
+}
@@ -0,0 +1,111 @@
+﻿#pragma once
+#include "Core/Object.hpp"
+#include "Core/Graphics/Renderer.hpp"
+#include <vector>
+
+namespace Core::Graphics
+{
+	// 无窗口模式和基准测试使用的空渲染器：接收绘制请求但不提交给显卡，
+	// 和 OpenGL 渲染器一样在切换纹理、混合模式和顶点缓冲区写满时提交（这里直接丢弃），只统计状态切换和绘制的顶点数
+
+	struct RenderStatistics_Null
+	{
+		uint64_t vertex{ 0 };
+		uint64_t index{ 0 };
+		uint64_t texture_switch{ 0 };
+		uint64_t blend_switch{ 0 };
+		uint64_t flush{ 0 };
+	};
+
+	class PostEffectShader_Null : public Object<IPostEffectShader>
+	{
+	public:
+		bool setFloat(StringView, float) { return true; }
+		bool setFloat2(StringView, Vector2F) { return true; }
+		bool setFloat3(StringView, Vector3F) { return true; }
+		bool setFloat4(StringView, Vector4F) { return true; }
+		bool setTexture2D(StringView, ITexture2D*) { return true; }
+		bool apply(IRenderer*) { return true; }
+	};
+
+	class Model_Null : public Object<IModel>
+	{
+	public:
+		void setAmbient(Vector3F const&, float) {}
+		void setDirectionalLight(Vector3F const&, Vector3F const&, float) {}
+		void setScaling(Vector3F const&) {}
+		void setPosition(Vector3F const&) {}
+		void setRotationRollPitchYaw(float, float, float) {}
+		void setRotationQuaternion(Vector4F const&) {}
+	};
+
+	class Renderer_Null : public Object<IRenderer>
+	{
+	private:
+		static constexpr size_t VERTEX_BUFFER_SIZE = 65536;
+		static constexpr size_t INDEX_BUFFER_SIZE = VERTEX_BUFFER_SIZE * 3 / 2;
+		std::vector<DrawVertex> m_vertex;
+		std::vector<DrawIndex> m_index;
+		size_t m_vertex_count{ 0 };
+		size_t m_index_count{ 0 };
+		ITexture2D* m_texture{ nullptr };
+		BlendState m_blend{ BlendState::Alpha };
+		BoxF m_viewport{};
+		bool m_batch_scope{ false };
+		RenderStatistics_Null m_stat;
+	public:
+		RenderStatistics_Null const& getStatistics() const noexcept { return m_stat; }
+		void resetStatistics() noexcept { m_stat = RenderStatistics_Null{}; }
+	public:
+		bool beginBatch() { m_batch_scope = true; return true; }
+		bool endBatch() { flush(); m_batch_scope = false; return true; }
+		bool isBatchScope() { return m_batch_scope; }
+		bool flush();
+
+		void clearRenderTarget(Color4B const&) {}
+		void clearDepthBuffer(float) {}
+		void setRenderAttachment(IRenderTarget*) { flush(); }
+
+		void setOrtho(BoxF const&) {}
+		void setPerspective(Vector3F const&, Vector3F const&, Vector3F const&, float, float, float, float) {}
+
+		BoxF getViewport() { return m_viewport; }
+		void setViewport(BoxF const& box) { m_viewport = box; }
+		void setScissorRect(RectF const&) {}
+		void setViewportAndScissorRect() {}
+
+		void setVertexColorBlendState(VertexColorBlendState) {}
+		void setFogState(FogState, Color4B const&, float, float) {}
+		void setDepthState(DepthState) {}
+		void setBlendState(BlendState state);
+		void setTexture(ITexture2D* texture);
+
+		bool drawTriangle(DrawVertex const& v1, DrawVertex const& v2, DrawVertex const& v3);
+		bool drawTriangle(DrawVertex const* pvert);
+		bool drawQuad(DrawVertex const& v1, DrawVertex const& v2, DrawVertex const& v3, DrawVertex const& v4);
+		bool drawQuad(DrawVertex const* pvert);
+		bool drawRaw(DrawVertex const* pvert, uint16_t nvert, DrawIndex const* pidx, uint16_t nidx);
+		bool drawRequest(uint16_t nvert, uint16_t nidx, DrawVertex** ppvert, DrawIndex** ppidx, uint16_t* idxoffset);
+
+		bool createPostEffectShader(StringView path, IPostEffectShader** pp_effect);
+		bool drawPostEffect(
+			IPostEffectShader*,
+			BlendState,
+			ITexture2D*, SamplerState,
+			Vector4F const*, size_t,
+			ITexture2D* const*, SamplerState const*, size_t) { flush(); return true; }
+		bool drawPostEffect(IPostEffectShader*, BlendState) { flush(); return true; }
+
+		bool createModel(StringView path, IModel** pp_model);
+		bool drawModel(IModel*) { flush(); return true; }
+
+		Graphics::SamplerState getKnownSamplerState(SamplerState) { return Graphics::SamplerState(); }
+
+	public:
+		Renderer_Null();
+		~Renderer_Null();
+
+	public:
+		static bool create(Renderer_Null** pp_renderer);
+	};
+}
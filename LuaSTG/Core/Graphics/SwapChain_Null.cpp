@@ -0,0 +1,38 @@
+﻿#include "Core/Graphics/SwapChain_Null.hpp"
+
+namespace Core::Graphics
+{
+	bool SwapChain_Null::setWindowMode(Vector2U size)
+	{
+		if (size.x < 1 || size.y < 1)
+			return false;
+		m_window->setWindowMode(size);
+		return true;
+	}
+	bool SwapChain_Null::setCanvasSize(Vector2U size)
+	{
+		if (size.x < 1 || size.y < 1)
+			return false;
+		m_canvas_size = size;
+		return true;
+	}
+
+	SwapChain_Null::SwapChain_Null(Window_Null* p_window)
+		: m_window(p_window)
+	{
+	}
+
+	bool SwapChain_Null::create(Window_Null* p_window, SwapChain_Null** pp_swapchain)
+	{
+		try
+		{
+			*pp_swapchain = new SwapChain_Null(p_window);
+			return true;
+		}
+		catch (...)
+		{
+			*pp_swapchain = nullptr;
+			return false;
+		}
+	}
+}
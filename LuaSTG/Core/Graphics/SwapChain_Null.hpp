@@ -0,0 +1,37 @@
+﻿#pragma once
+#include "Core/Object.hpp"
+#include "Core/Graphics/SwapChain.hpp"
+#include "Core/Graphics/Window_Null.hpp"
+
+namespace Core::Graphics
+{
+	// 无窗口模式使用的空交换链：只记录画布尺寸，不产生交换链事件，呈现和截图什么都不做
+
+	class SwapChain_Null : public Object<ISwapChain>
+	{
+	private:
+		ScopeObject<Window_Null> m_window;
+		Vector2U m_canvas_size{ 640, 480 };
+
+	public:
+		void addEventListener(ISwapChainEventListener*) {}
+		void removeEventListener(ISwapChainEventListener*) {}
+
+		bool setWindowMode(Vector2U size);
+		bool setCanvasSize(Vector2U size);
+		Vector2U getCanvasSize() { return m_canvas_size; }
+
+		void clearRenderAttachment() {}
+		void applyRenderAttachment() {}
+		void setVSync(bool) {}
+		bool present() { return true; }
+
+		bool saveSnapshotToFile(StringView) { return false; }
+
+	public:
+		explicit SwapChain_Null(Window_Null* p_window);
+
+	public:
+		static bool create(Window_Null* p_window, SwapChain_Null** pp_swapchain);
+	};
+}
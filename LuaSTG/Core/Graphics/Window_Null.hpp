@@ -0,0 +1,77 @@
+﻿#pragma once
+#include "Core/Object.hpp"
+#include "Core/Graphics/Window.hpp"
+#include "Core/Type.hpp"
+#include <cstdint>
+#include <string>
+
+namespace Core::Graphics
+{
+	// 无窗口模式使用的空窗口：不创建系统窗口，只记录标题、尺寸等状态，不产生任何窗口事件；
+	// 只有一个和窗口同样大小的显示器，文本输入和剪贴板只保存在内存中
+
+	class Window_Null : public Object<IWindow>
+	{
+	private:
+		std::string m_title{ "Window" };
+		Vector2U m_size{ 640, 480 };
+		WindowFrameStyle m_framestyle{ WindowFrameStyle::Fixed };
+		WindowLayer m_layer{ WindowLayer::Invisible };
+		WindowCursor m_cursor{ WindowCursor::Arrow };
+		std::string m_text_input;
+		std::string m_clipboard;
+
+	public:
+		void addEventListener(IWindowEventListener*) {}
+		void removeEventListener(IWindowEventListener*) {}
+
+		void* getNativeHandle() { return nullptr; }
+
+		void setTitleText(StringView str) { m_title = str; }
+		StringView getTitleText() { return m_title; }
+
+		bool setFrameStyle(WindowFrameStyle style) { m_framestyle = style; return true; }
+		WindowFrameStyle getFrameStyle() { return m_framestyle; }
+
+		Vector2U getSize() { return m_size; }
+		bool setSize(Vector2U v) { m_size = v; return true; }
+
+		WindowLayer getLayer() { return m_layer; }
+		bool setLayer(WindowLayer layer) { m_layer = layer; return true; }
+
+		void setWindowMode(Vector2U size) { m_size = size; }
+		void setExclusiveFullScreenMode() {}
+		void setBorderlessFullScreenMode() {}
+
+		uint32_t getMonitorCount() { return 1; }
+		RectI getMonitorRect(uint32_t) { return RectI(0, 0, (int32_t)m_size.x, (int32_t)m_size.y); }
+		void setMonitorCentered(uint32_t) {}
+		void setMonitorFullScreen(uint32_t) {}
+
+		bool setCursor(WindowCursor type) { m_cursor = type; return true; }
+		WindowCursor getCursor() { return m_cursor; }
+
+		void setTextInputEnable(bool) {}
+		std::string getTextInput() { return m_text_input; }
+		std::string getIMEComp() { return {}; }
+		void setTextInput(StringView text) { m_text_input = text; }
+		void clearTextInput() { m_text_input.clear(); }
+		uint32_t getTextInputLength() { return 0; }
+		uint32_t getTextCursorPos() { return 0; }
+		uint32_t getTextCursorPosRaw() { return 0; }
+		int32_t getIMECursorPos() { return -1; }
+		bool setTextCursorPos(uint32_t) { return false; }
+		void insertInputTextAtCursor(StringView, bool) {}
+		bool insertInputText(StringView, uint32_t) { return false; }
+		uint32_t removeInputTextAtCursor(uint32_t, bool) { return 0; }
+		int32_t removeInputText(uint32_t, uint32_t) { return 0; }
+		void setTextInputReturnEnable(bool) {}
+		void setTextInputRect(RectI) {}
+
+		std::string getClipboardText() { return m_clipboard; }
+		bool setClipboardText(StringView text) { m_clipboard = text; return true; }
+
+	public:
+		static bool create(Window_Null** pp_window);
+	};
+}
@@ -26,6 +26,8 @@ namespace Core
         
         SET(target_frame_rate);
 
+        SET(object_pool_capacity);
+
         SET(music_channel_volume);
         SET(sound_effect_channel_volume);
 
@@ -60,6 +62,8 @@ namespace Core
         GET(window_cursor_enable);
         
         GET(target_frame_rate);
+
+        GET(object_pool_capacity);
         
         GET(music_channel_volume);
         GET(sound_effect_channel_volume);
@@ -125,6 +129,8 @@ namespace Core
 
         target_frame_rate = 60;
 
+        object_pool_capacity = 32768;
+
         music_channel_volume = 1.0f;
         sound_effect_channel_volume = 1.0f;
 
@@ -20,6 +20,8 @@ namespace Core
 
         int target_frame_rate = 60;
 
+        int object_pool_capacity = 32768;
+
         float music_channel_volume = 1.0f;
         float sound_effect_channel_volume = 1.0f;
 
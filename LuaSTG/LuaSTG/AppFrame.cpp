@@ -2,6 +2,9 @@
 #include "Core/FileManager.hpp"
 #include "Debugger/ImGuiExtension.h"
 #include "LuaBinding/LuaAppFrame.hpp"
+#include "Platform/CommandLineArguments.hpp"
+#include <algorithm>
+#include <charconv>
 
 using namespace LuaSTGPlus;
 
@@ -125,7 +128,8 @@ bool AppFrame::Init()noexcept
     
     //////////////////////////////////////// Initialize Engine
     {
-        if (!Core::IApplicationModel::create(this, ~m_pAppModel))
+        ReadCommandLineArguments();
+        if (!Core::IApplicationModel::create(this, ~m_pAppModel, m_bHeadless))
             return false;
         if (!Core::Graphics::ITextRenderer::create(m_pAppModel->getRenderer(), ~m_pTextRenderer))
             return false;
@@ -133,10 +137,13 @@ bool AppFrame::Init()noexcept
             return false;
 
         // Allocate space for object pools
-        spdlog::info("[luastg] Initializing object pool with capacity: {}", LOBJPOOL_SIZE);
+        // Command line overrides launch script and config
+        if (m_uCommandLineObjectPoolCapacity > 0)
+            m_Setting.object_pool_capacity = m_uCommandLineObjectPoolCapacity;
+        spdlog::info("[luastg] Initializing object pool with capacity: {}", m_Setting.object_pool_capacity);
         try
         {
-            m_GameObjectPool = std::make_unique<GameObjectPool>(L);
+            m_GameObjectPool = std::make_unique<GameObjectPool>(L, m_Setting.object_pool_capacity);
         }
         catch (const std::bad_alloc&)
         {
@@ -150,8 +157,10 @@ bool AppFrame::Init()noexcept
         OpenInput();
 
         // Initialize ImGui
+        // 无窗口模式没有 SDL 窗口和 OpenGL 上下文，不初始化 ImGui
         #ifdef USING_DEAR_IMGUI
-            imgui::bindEngine();
+            if (!m_bHeadless)
+                imgui::bindEngine();
         #endif
         
         if (!InitializationApplySettingStage2())
@@ -197,7 +206,8 @@ void AppFrame::Shutdown()noexcept
     
     // 卸载ImGui
     #ifdef USING_DEAR_IMGUI
-        imgui::unbindEngine();
+        if (!m_bHeadless)
+            imgui::unbindEngine();
     #endif
 
     GFileManager().unloadAllFileArchive();
@@ -225,6 +235,96 @@ void AppFrame::Run()noexcept
     m_pAppModel->getWindow()->removeEventListener(this);
 
     spdlog::info("[luastg] Exiting Update & Render Loop");
+
+    if (m_bHeadless)
+        PrintHeadlessReport();
+}
+void AppFrame::ReadCommandLineArguments()
+{
+    // --headless                   run without window, rendering and frame rate limit
+    // --headless-frames=<n>        exit after n frames
+    // --object-pool-capacity=<n>   object pool capacity, overrides launch script and config
+    constexpr std::string_view option_frames("--headless-frames=");
+    constexpr std::string_view option_capacity("--object-pool-capacity=");
+    std::vector<std::string_view> args;
+    Platform::CommandLineArguments::Get().GetArguments(args);
+    for (auto const& arg : args)
+    {
+        if (arg == "--headless")
+        {
+            m_bHeadless = true;
+        }
+        else if (arg.starts_with(option_frames))
+        {
+            uint64_t v = 0;
+            auto const value = arg.substr(option_frames.size());
+            auto const r = std::from_chars(value.data(), value.data() + value.size(), v);
+            if (r.ec == std::errc())
+                m_uHeadlessFrameLimit = v;
+            else
+                spdlog::warn("[luastg] Invalid command line argument '{}'", arg);
+        }
+        else if (arg.starts_with(option_capacity))
+        {
+            uint32_t v = 0;
+            auto const value = arg.substr(option_capacity.size());
+            auto const r = std::from_chars(value.data(), value.data() + value.size(), v);
+            if (r.ec == std::errc() && v > 0)
+                m_uCommandLineObjectPoolCapacity = std::min<uint32_t>(v, LOBJPOOL_SIZE_MAX);
+            else
+                spdlog::warn("[luastg] Invalid command line argument '{}'", arg);
+        }
+    }
+    if (m_bHeadless)
+    {
+        if (m_uHeadlessFrameLimit > 0)
+            spdlog::info("[luastg] Headless mode, frame limit: {}", m_uHeadlessFrameLimit);
+        else
+            spdlog::info("[luastg] Headless mode, no frame limit");
+    }
+}
+void AppFrame::PrintHeadlessReport()
+{
+    auto const total = m_pAppModel->getTotalFrameStatistics();
+    double const frames = (double)std::max<uint64_t>(m_uHeadlessFrameCount, 1);
+    double const fps = total.total_time > 0.0 ? (double)m_uHeadlessFrameCount / total.total_time : 0.0;
+    auto const& pool = m_HeadlessPoolStatistics;
+    // 各阶段耗时只由 ObjStep 记录，脚本分别调用 ObjFrame、BoundCheck 等函数时没有阶段耗时
+    bool const has_step_time = std::any_of(pool.step_time.begin(), pool.step_time.end(), [](double v) { return v > 0.0; });
+    std::string const step_time = has_step_time
+        ? fmt::format("frame {:.4f} ms, bound {:.4f} ms, collision {:.4f} ms, after-frame {:.4f} ms",
+            pool.step_time[0] / frames,
+            pool.step_time[1] / frames,
+            pool.step_time[2] / frames,
+            pool.step_time[3] / frames)
+        : std::string("phase timings unavailable (lstg.ObjStep not used)");
+    // 帧统计的单位是秒，ObjStep 各阶段的单位是毫秒
+    std::string const report = fmt::format(
+        "[luastg] Headless report\n"
+        "    frames          : {}\n"
+        "    wall time       : {:.3f} s\n"
+        "    frames/sec      : {:.1f}\n"
+        "    update (avg)    : {:.4f} ms\n"
+        "    wait   (avg)    : {:.4f} ms\n"
+        "    objects         : {:.1f} alloc/frame, {:.1f} free/frame, {} peak alive\n"
+        "    collision (avg) : {:.1f} checks/frame, {:.1f} callbacks/frame\n"
+        "    ObjStep (avg)   : {}",
+        m_uHeadlessFrameCount,
+        total.total_time,
+        fps,
+        total.update_time * 1000.0 / frames,
+        total.wait_time * 1000.0 / frames,
+        (double)pool.object_alloc / frames,
+        (double)pool.object_free / frames,
+        pool.object_alive,
+        (double)pool.object_colli_check / frames,
+        (double)pool.object_colli_callback / frames,
+        step_time);
+    spdlog::info("{}", report);
+    // 日志可能只写入文件，这里同时输出到标准输出
+    std::fputs(report.c_str(), stdout);
+    std::fputc('\n', stdout);
+    std::fflush(stdout);
 }
 
 #pragma endregion
@@ -313,6 +413,20 @@ bool AppFrame::onUpdate()
             result = false;
             m_pAppModel->requestExit();
         }
+        if (m_bHeadless)
+        {
+            // 本帧的统计，在帧函数之后累加，最后一帧也会被计入
+            auto const stat = m_GameObjectPool->DebugGetCurrentFrameStatistics();
+            auto& total = m_HeadlessPoolStatistics;
+            total.object_alloc += stat.object_alloc;
+            total.object_free += stat.object_free;
+            total.object_alive = std::max(total.object_alive, stat.object_alive);
+            total.object_colli_check += stat.object_colli_check;
+            total.object_colli_callback += stat.object_colli_callback;
+            total.object_table_reuse += stat.object_table_reuse;
+            for (size_t i = 0; i < stat.step_time.size(); i += 1)
+                total.step_time[i] += stat.step_time[i];
+        }
         bool tAbort = lua_toboolean(L, -1) != 0;
         lua_pop(L, 1);
         if (tAbort)
@@ -320,6 +434,13 @@ bool AppFrame::onUpdate()
         m_ResourceMgr.UpdateSound();
     }
 
+    if (m_bHeadless)
+    {
+        m_uHeadlessFrameCount += 1;
+        if (m_uHeadlessFrameLimit > 0 && m_uHeadlessFrameCount >= m_uHeadlessFrameLimit)
+            m_pAppModel->requestExit();
+    }
+
     ResetKeyboardInput();
 
     return result;
@@ -39,6 +39,9 @@ namespace LuaSTGPlus
         float volume_sound_effect{ 1.0f };
         // Volume: BGM
         float volume_music{ 1.0f };
+
+        // Object pool capacity
+        uint32_t object_pool_capacity{ LOBJPOOL_SIZE };
     };
 
     struct IRenderTargetManager
@@ -93,6 +96,18 @@ namespace LuaSTGPlus
         // Rendering state
         bool m_bRenderStarted = false;
 
+        // Headless mode, see '--headless'
+        bool m_bHeadless = false;
+        uint64_t m_uHeadlessFrameLimit = 0; // 0 = unlimited
+        uint64_t m_uHeadlessFrameCount = 0;
+        GameObjectPool::FrameStatistics m_HeadlessPoolStatistics{}; // object pool statistics accumulated over all frames, object_alive is the peak
+
+        // Command line, see 'ReadCommandLineArguments'
+        uint32_t m_uCommandLineObjectPoolCapacity = 0; // 0 = not specified
+
+        void ReadCommandLineArguments();
+        void PrintHeadlessReport();
+
     public:
         /// Protected mode script execution
         /// Framework-only, called from the outermost level of main logic.
@@ -184,6 +199,10 @@ namespace LuaSTGPlus
 
         void SetResolution(uint32_t width, uint32_t height);
 
+        // Sets object pool capacity, launch-only.
+        // Can be overridden by command line argument '--object-pool-capacity=<n>'.
+        void SetObjectPoolCapacity(uint32_t v);
+
     public: // Other framework methods
 
         // Set target FPS
@@ -192,6 +211,10 @@ namespace LuaSTGPlus
         // Get current average FPS
         double GetFPS() const noexcept { return m_fAvgFPS; }
 
+        // Headless fixed-step simulation, enabled by command line argument '--headless'.
+        // No window is shown, nothing is rendered and frames are not throttled.
+        bool IsHeadless() const noexcept { return m_bHeadless; }
+
         // Read a text file from a resource package.  
         // It is possible to read other files, but you may get meaningless results.
         int LoadTextFile(lua_State* L, const char* path, const char *packname) noexcept;
@@ -281,6 +304,10 @@ namespace LuaSTGPlus
 
         Core::IApplicationModel* GetAppModel() { return m_pAppModel.get(); }
         Core::Graphics::IRenderer* GetRenderer2D() { return m_pAppModel->getRenderer(); }
+#ifdef LUASTG_BENCHMARK
+        // 基准测试不初始化框架，用替代的应用模型创建资源和驱动渲染路径
+        void SetAppModel(Core::IApplicationModel* model) { m_pAppModel = model; }
+#endif // LUASTG_BENCHMARK
 
     public:
         /// Initialize framework
@@ -219,4 +219,14 @@ namespace LuaSTGPlus
         else if (m_iStatus == AppStatus::Running)
             spdlog::warn("[luastg] SetResolution: launch-only function called at runtime");
     }
+
+    void AppFrame::SetObjectPoolCapacity(uint32_t v)
+    {
+        if (m_iStatus == AppStatus::Initializing)
+        {
+            m_Setting.object_pool_capacity = std::clamp<uint32_t>(v, 1u, LOBJPOOL_SIZE_MAX);
+        }
+        else if (m_iStatus == AppStatus::Running)
+            spdlog::warn("[luastg] SetObjectPoolCapacity: launch-only function called at runtime");
+    }
 }
@@ -12,6 +12,22 @@ namespace LuaSTGPlus
     static SDL_Keycode lastKeyDown;
     static SDL_Keycode lastKeyUp;
     static Core::Vector2I mouseWheelDelta;
+
+    static void GetWindowSizeInPixels(Core::Graphics::IWindow* window, Core::Vector2I& size)
+    {
+        auto const handle = reinterpret_cast<SDL_Window*>(window->getNativeHandle());
+        if (handle)
+        {
+            SDL_GetWindowSizeInPixels(handle, &size.x, &size.y);
+        }
+        else
+        {
+            // 无窗口模式没有 SDL 窗口，使用空窗口记录的尺寸
+            auto const window_size = window->getSize();
+            size.x = (int32_t)window_size.x;
+            size.y = (int32_t)window_size.y;
+        }
+    }
 }
 
 static struct InputEventListener : public Core::Graphics::IWindowEventListener
@@ -156,7 +172,7 @@ namespace LuaSTGPlus
     {
         if (m_sdl_window_size.x == 0 || m_sdl_window_size.y == 0)
         {
-            SDL_GetWindowSizeInPixels(reinterpret_cast<SDL_Window*>(GetAppModel()->getWindow()->getNativeHandle()), &m_sdl_window_size.x, &m_sdl_window_size.y);
+            GetWindowSizeInPixels(GetAppModel()->getWindow(), m_sdl_window_size);
         }
         auto const w_size = m_sdl_window_size;
         auto const c_size = GetAppModel()->getSwapChain()->getCanvasSize();
@@ -176,7 +192,7 @@ namespace LuaSTGPlus
     {
         if (m_sdl_window_size.x == 0 || m_sdl_window_size.y == 0)
         {
-            SDL_GetWindowSizeInPixels(reinterpret_cast<SDL_Window*>(GetAppModel()->getWindow()->getNativeHandle()), &m_sdl_window_size.x, &m_sdl_window_size.y);
+            GetWindowSizeInPixels(GetAppModel()->getWindow(), m_sdl_window_size);
         }
         auto const w_size = m_sdl_window_size;
         return Core::Vector2F((float)w_size.x, (float)w_size.y);
@@ -185,7 +201,7 @@ namespace LuaSTGPlus
     {
         if (m_sdl_window_size.x == 0 || m_sdl_window_size.y == 0)
         {
-            SDL_GetWindowSizeInPixels(reinterpret_cast<SDL_Window*>(GetAppModel()->getWindow()->getNativeHandle()), &m_sdl_window_size.x, &m_sdl_window_size.y);
+            GetWindowSizeInPixels(GetAppModel()->getWindow(), m_sdl_window_size);
         }
         auto const w_size = m_sdl_window_size;
         auto const c_size = GetAppModel()->getSwapChain()->getCanvasSize();
@@ -94,7 +94,9 @@ namespace LuaSTGPlus
                     errmsg = "(error object is a nil value)";
                 }
                 spdlog::error("[luajit] Error when running '{}':{}", desc, errmsg);
-                Platform::MessageBox::ErrorFromWindow(LUASTG_INFO, fmt::format("Error when running '{}':\n{}", desc, errmsg), m_pAppModel->getWindow()->getNativeHandle());
+                // 无窗口模式只写日志，不弹出对话框阻塞进程
+                if (!m_bHeadless)
+                    Platform::MessageBox::ErrorFromWindow(LUASTG_INFO, fmt::format("Error when running '{}':\n{}", desc, errmsg), m_pAppModel->getWindow()->getNativeHandle());
             }
             catch (const std::bad_alloc&)
             {
@@ -132,7 +134,8 @@ namespace LuaSTGPlus
                     errmsg = "(error object is a nil value)";
                 }
                 spdlog::error("[luajit] Error when calling global function '{}':{}", name, errmsg);
-                Platform::MessageBox::ErrorFromWindow(LUASTG_INFO, fmt::format("Error when calling global function '{}':\n{}", name, errmsg), m_pAppModel->getWindow()->getNativeHandle());
+                if (!m_bHeadless)
+                    Platform::MessageBox::ErrorFromWindow(LUASTG_INFO, fmt::format("Error when calling global function '{}':\n{}", name, errmsg), m_pAppModel->getWindow()->getNativeHandle());
             }
             catch (const std::bad_alloc&)
             {
@@ -180,7 +183,8 @@ namespace LuaSTGPlus
             try
             {
                 spdlog::error("[luajit] Error when calling global function '{}':{}", name, lua_tostring(L, -1));
-                Platform::MessageBox::ErrorFromWindow(LUASTG_INFO, fmt::format("Error when calling global function '{}':\n{}", name, lua_tostring(L, -1)), m_pAppModel->getWindow()->getNativeHandle());
+                if (!m_bHeadless)
+                    Platform::MessageBox::ErrorFromWindow(LUASTG_INFO, fmt::format("Error when calling global function '{}':\n{}", name, lua_tostring(L, -1)), m_pAppModel->getWindow()->getNativeHandle());
             }
             catch (const std::bad_alloc&)
             {
@@ -0,0 +1,541 @@
+﻿// GameObjectPool 基准测试
+// 不创建窗口和图形设备，只创建 LuaJIT 虚拟机和对象池，用合成场景驱动对象池的各个阶段；
+// render_ 开头的场景给对象设置精灵和动画，资源建立在无窗口模式的空应用模型上（见 Core/ApplicationModel_Null.hpp），
+// DoRender 会执行剔除、批量绘制和图像状态的路径，绘制请求写入缓冲区后丢弃。
+// 结果以 JSON 输出到标准输出，单位为每个对象的纳秒数，方便逐个提交比较。
+//
+// 参数：
+//   --frames=<n>       每个场景计时的帧数，默认 300
+//   --warmup=<n>       每个场景计时前运行的帧数，默认 30
+//   --filter=<text>    只运行名称包含 text 的场景
+//   --output=<path>    把结果写入文件而不是标准输出
+
+#include "AppFrame.h"
+#include "Core/ApplicationModel_Null.hpp"
+#include "LuaBinding/LuaWrapper.hpp"
+#include "Platform/CommandLineArguments.hpp"
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+
+namespace
+{
+	using namespace LuaSTGPlus;
+
+	// 场景脚本，类的写法与 lstg 的 Class 相同：is_class 为真，1~6 为回调函数，default_function 标记使用默认实现的回调
+	constexpr char const BENCHMARK_SCRIPT[] = R"(
+local bench = {}
+
+local function noop() end
+local DEFAULT_ALL = 126 -- init、del、frame、render、colli、kill
+
+local function class(mask, frame, render, colli)
+	return { is_class = true, default_function = mask, noop, noop, frame or noop, render or noop, colli or noop, noop }
+end
+
+-- 全部使用默认回调的子弹
+bench.bullet = class(DEFAULT_ALL)
+-- frame、render、colli 回调在 lua 中执行
+bench.scripted = class(DEFAULT_ALL - 8 - 16 - 32, function(self)
+	self.rot = self.rot + 1
+end, noop, noop)
+
+local random = math.random
+local ring = {}
+local ring_head = 0
+
+-- 图片种类：0 无图片，1 精灵，2 精灵与动画交替
+local images = { {}, { "bench_sprite" }, { "bench_sprite", "bench_animation" } }
+local image_list = images[1]
+local img_state_every = 0
+local decorated = 0
+
+function bench.reset(seed)
+	math.randomseed(seed)
+	ring = {}
+	ring_head = 0
+end
+
+-- 设置之后创建的对象使用的图片，every 不为 0 时每 every 个对象设置一次图像状态
+function bench.set_image(kind, every)
+	image_list = images[kind + 1]
+	img_state_every = every
+	decorated = 0
+end
+
+local function decorate(o)
+	local n = #image_list
+	if n > 0 then
+		decorated = decorated + 1
+		o.img = image_list[decorated % n + 1]
+		if img_state_every > 0 and decorated % img_state_every == 0 then
+			lstg.SetImgState(o, "mul+add", 255, 255, 128, 128)
+		end
+	end
+end
+
+-- 在 [-r, r] 范围内生成 n 个对象，速度在 [-v, v] 内，track 不为 0 时对象会被 churn 替换
+function bench.spawn(cls, n, group, r, v, track)
+	for _ = 1, n do
+		local o = lstg.New(cls)
+		decorate(o)
+		o.group = group
+		o.x = (random() * 2 - 1) * r
+		o.y = (random() * 2 - 1) * r
+		o.vx = (random() * 2 - 1) * v
+		o.vy = (random() * 2 - 1) * v
+		o.a = 2
+		o.b = 2
+		if track ~= 0 then
+			ring[#ring + 1] = o
+		end
+	end
+end
+
+-- 删除最早创建的 k 个对象并创建 k 个新对象
+function bench.churn(cls, k, group, r, v)
+	local n = #ring
+	for _ = 1, k do
+		ring_head = ring_head % n + 1
+		lstg.Del(ring[ring_head])
+		local o = lstg.New(cls)
+		decorate(o)
+		o.group = group
+		o.x = (random() * 2 - 1) * r
+		o.y = (random() * 2 - 1) * r
+		o.vx = (random() * 2 - 1) * v
+		o.vy = (random() * 2 - 1) * v
+		o.a = 2
+		o.b = 2
+		ring[ring_head] = o
+	end
+end
+
+return bench
+)";
+
+	enum class Phase : size_t
+	{
+		Churn,
+		Frame,
+		BoundCheck,
+		CollisionCheck,
+		UpdateXY,
+		AfterFrame,
+		Render,
+		Count,
+	};
+
+	constexpr std::string_view PHASE_NAMES[(size_t)Phase::Count] = {
+		"churn",
+		"frame",
+		"bound_check",
+		"collision_check",
+		"update_xy",
+		"after_frame",
+		"render",
+	};
+
+	struct Scene
+	{
+		std::string name;
+		uint32_t bullet_count{ 0 };   // 默认回调的子弹
+		uint32_t scripted_count{ 0 }; // lua 回调的子弹
+		uint32_t bullet_groups{ 1 };  // 子弹分布在 N 个碰撞组中
+		uint32_t target_groups{ 1 };  // 目标分布在 M 个碰撞组中，碰撞对为 N×M
+		uint32_t target_count{ 16 };  // 每个目标组的对象数
+		uint32_t churn_per_frame{ 0 };
+		uint32_t image{ 0 };          // 0 无图片，1 精灵，2 精灵与动画交替
+		uint32_t img_state_every{ 0 }; // 每 N 个有图片的对象设置一次图像状态，0 表示不设置
+		bool cull{ false };            // 启用渲染剔除，剔除矩形比生成范围小
+	};
+
+	struct PhaseResult
+	{
+		double time_ns{ 0.0 };
+		double object_frames{ 0.0 }; // 每帧阶段开始时存活对象数的总和
+	};
+
+	struct SceneResult
+	{
+		Scene const* scene{ nullptr };
+		uint32_t frames{ 0 };
+		size_t objects_begin{ 0 };
+		size_t objects_end{ 0 };
+		std::array<PhaseResult, (size_t)Phase::Count> phases{};
+		Core::Graphics::RenderStatistics_Null render{};
+		uint64_t render_culled{ 0 };
+		uint64_t render_batched{ 0 };
+	};
+
+	class Benchmark
+	{
+	private:
+		lua_State* L{ nullptr };
+		std::unique_ptr<GameObjectPool> m_Pool;
+		Core::ScopeObject<Core::ApplicationModel_Null> m_AppModel;
+		int m_BenchIdx{ 0 };
+		uint32_t m_Frames{ 300 };
+		uint32_t m_Warmup{ 30 };
+
+		static constexpr size_t TARGET_GROUP_BASE = 8;
+		static constexpr lua_Number SPAWN_RANGE = 200.0;
+		static constexpr lua_Number SPAWN_SPEED = 1.0;
+		static constexpr float CULL_RANGE = 120.0f;
+
+		bool _Call(char const* name, std::initializer_list<lua_Number> args, char const* class_name = nullptr)
+		{
+			lua_getfield(L, m_BenchIdx, name);
+			int argc = 0;
+			if (class_name)
+			{
+				lua_getfield(L, m_BenchIdx, class_name);
+				argc += 1;
+			}
+			for (auto const v : args)
+			{
+				lua_pushnumber(L, v);
+				argc += 1;
+			}
+			if (0 != lua_pcall(L, argc, 0, 0))
+			{
+				std::fprintf(stderr, "benchmark: %s\n", lua_tostring(L, -1));
+				lua_pop(L, 1);
+				return false;
+			}
+			return true;
+		}
+		bool _Setup(Scene const& scene)
+		{
+			m_Pool->ResetPool();
+			m_Pool->SetBound(-100000.0, 100000.0, -100000.0, 100000.0);
+			std::vector<GameObjectPool::CollisionPair> pairs;
+			for (uint32_t i = 0; i < scene.bullet_groups; i += 1)
+			{
+				for (uint32_t j = 0; j < scene.target_groups; j += 1)
+				{
+					pairs.push_back(GameObjectPool::CollisionPair{ 1 + i, TARGET_GROUP_BASE + j, 0, false });
+				}
+			}
+			m_Pool->SetCollisionPairs(pairs);
+			m_Pool->SetRenderCulling(scene.cull, 0.0f);
+			if (scene.cull)
+				m_Pool->SetRenderCullRect(-CULL_RANGE, CULL_RANGE, -CULL_RANGE, CULL_RANGE);
+			else
+				m_Pool->ResetRenderCullRect();
+			if (!_Call("reset", { 12345.0 }) || !_Call("set_image", { (lua_Number)scene.image, (lua_Number)scene.img_state_every }))
+				return false;
+			// 子弹平均分配到各个碰撞组
+			auto spawn = [&](char const* class_name, uint32_t count) -> bool
+			{
+				for (uint32_t i = 0; i < scene.bullet_groups; i += 1)
+				{
+					uint32_t const n = count / scene.bullet_groups + (i < count % scene.bullet_groups ? 1 : 0);
+					if (!_Call("spawn", { (lua_Number)n, (lua_Number)(1 + i), SPAWN_RANGE, SPAWN_SPEED, 1.0 }, class_name))
+						return false;
+				}
+				return true;
+			};
+			if (!spawn("bullet", scene.bullet_count) || !spawn("scripted", scene.scripted_count))
+				return false;
+			for (uint32_t j = 0; j < scene.target_groups; j += 1)
+			{
+				if (!_Call("spawn", { (lua_Number)scene.target_count, (lua_Number)(TARGET_GROUP_BASE + j), SPAWN_RANGE, 0.0, 0.0 }, "bullet"))
+					return false;
+			}
+			return true;
+		}
+		template<typename F>
+		bool _Measure(PhaseResult* result, F&& f)
+		{
+			using Clock = std::chrono::steady_clock;
+			size_t const count = m_Pool->GetObjectCount();
+			auto const t0 = Clock::now();
+			bool const ok = f();
+			auto const t1 = Clock::now();
+			if (result)
+			{
+				result->time_ns += (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+				result->object_frames += (double)count;
+			}
+			return ok;
+		}
+		bool _RunFrame(Scene const& scene, SceneResult* result)
+		{
+			auto phase = [&](Phase p) -> PhaseResult* { return result ? &result->phases[(size_t)p] : nullptr; };
+			bool ok = true;
+			m_Pool->DebugNextFrame();
+			if (scene.churn_per_frame > 0)
+			{
+				ok = _Measure(phase(Phase::Churn), [&]
+				{
+					return _Call("churn", { (lua_Number)scene.churn_per_frame, 1.0, SPAWN_RANGE, SPAWN_SPEED }, "bullet");
+				});
+			}
+			_Measure(phase(Phase::Frame), [&] { m_Pool->DoFrame(); return true; });
+			_Measure(phase(Phase::BoundCheck), [&] { m_Pool->BoundCheck(); return true; });
+			_Measure(phase(Phase::CollisionCheck), [&] { m_Pool->CollisionCheckAll(); return true; });
+			_Measure(phase(Phase::UpdateXY), [&] { m_Pool->UpdateXY(); return true; });
+			_Measure(phase(Phase::AfterFrame), [&] { m_Pool->AfterFrame(); return true; });
+			_Measure(phase(Phase::Render), [&] { m_Pool->DoRender(); m_AppModel->getNullRenderer()->flush(); return true; });
+			if (result)
+			{
+				auto const stat = m_Pool->DebugGetCurrentFrameStatistics();
+				result->render_culled += stat.object_render_culled;
+				result->render_batched += stat.object_render_batched;
+			}
+			return ok;
+		}
+
+	public:
+		bool Initialize(uint32_t frames, uint32_t warmup)
+		{
+			m_Frames = frames;
+			m_Warmup = warmup;
+			L = luaL_newstate();
+			if (!L)
+				return false;
+			luaL_openlibs(L);
+			LuaWrapper::GameObjectManagerWrapper::Register(L);
+			lua_settop(L, 0);
+			m_Pool = std::make_unique<GameObjectPool>(L, 65536);
+			// 空应用模型只用于创建精灵资源和接收绘制请求，不调用 run
+			m_AppModel.attach(new Core::ApplicationModel_Null(nullptr));
+			LAPP.SetAppModel(m_AppModel.get());
+			ResourcePool* pool = LRES.GetResourcePool(ResourcePoolType::Global);
+			if (!pool->CreateTexture("bench_texture", 256, 256)
+				|| !pool->CreateSprite("bench_sprite", "bench_texture", 0.0, 0.0, 16.0, 16.0, 2.0, 2.0)
+				|| !pool->CreateAnimation("bench_animation", "bench_texture", 0.0, 16.0, 16.0, 16.0, 4, 1, 4, 2.0, 2.0))
+			{
+				std::fprintf(stderr, "benchmark: can't create image resources\n");
+				return false;
+			}
+			if (0 != luaL_loadbuffer(L, BENCHMARK_SCRIPT, sizeof(BENCHMARK_SCRIPT) - 1, "benchmark") || 0 != lua_pcall(L, 0, 1, 0))
+			{
+				std::fprintf(stderr, "benchmark: %s\n", lua_tostring(L, -1));
+				return false;
+			}
+			m_BenchIdx = lua_gettop(L);
+			return true;
+		}
+		void Shutdown()
+		{
+			m_Pool = nullptr;
+			LRES.GetResourcePool(ResourcePoolType::Global)->Clear();
+			LAPP.SetAppModel(nullptr);
+			m_AppModel = nullptr;
+			if (L)
+			{
+				lua_close(L);
+				L = nullptr;
+			}
+		}
+		bool Run(Scene const& scene, SceneResult& result)
+		{
+			result = SceneResult{};
+			result.scene = &scene;
+			result.frames = m_Frames;
+			if (!_Setup(scene))
+				return false;
+			for (uint32_t i = 0; i < m_Warmup; i += 1)
+			{
+				if (!_RunFrame(scene, nullptr))
+					return false;
+			}
+			lua_gc(L, LUA_GCCOLLECT, 0);
+			m_AppModel->getNullRenderer()->resetStatistics();
+			result.objects_begin = m_Pool->GetObjectCount();
+			for (uint32_t i = 0; i < m_Frames; i += 1)
+			{
+				if (!_RunFrame(scene, &result))
+					return false;
+			}
+			result.objects_end = m_Pool->GetObjectCount();
+			result.render = m_AppModel->getNullRenderer()->getStatistics();
+			return true;
+		}
+	};
+
+	std::vector<Scene> MakeScenes()
+	{
+		std::vector<Scene> scenes;
+		for (uint32_t const n : { 1000u, 8000u, 32000u })
+		{
+			Scene s;
+			s.name = fmt::format("default_{}", n);
+			s.bullet_count = n;
+			scenes.push_back(s);
+		}
+		for (uint32_t const n : { 1000u, 8000u, 32000u })
+		{
+			Scene s;
+			s.name = fmt::format("mixed_{}", n);
+			s.bullet_count = n / 2;
+			s.scripted_count = n - n / 2;
+			scenes.push_back(s);
+		}
+		for (auto const& [g, t] : { std::pair{ 2u, 2u }, std::pair{ 4u, 4u } })
+		{
+			Scene s;
+			s.name = fmt::format("groups_{}x{}_8000", g, t);
+			s.bullet_count = 8000;
+			s.bullet_groups = g;
+			s.target_groups = t;
+			scenes.push_back(s);
+		}
+		for (uint32_t const n : { 1000u, 8000u, 32000u })
+		{
+			Scene s;
+			s.name = fmt::format("churn_{}", n);
+			s.bullet_count = n;
+			s.churn_per_frame = n / 10;
+			scenes.push_back(s);
+		}
+		for (uint32_t const n : { 8000u, 32000u })
+		{
+			Scene s;
+			s.name = fmt::format("render_sprite_{}", n);
+			s.bullet_count = n;
+			s.image = 1;
+			scenes.push_back(s);
+		}
+		for (uint32_t const n : { 8000u, 32000u })
+		{
+			Scene s;
+			s.name = fmt::format("render_cull_{}", n);
+			s.bullet_count = n;
+			s.image = 1;
+			s.cull = true;
+			scenes.push_back(s);
+		}
+		{
+			Scene s;
+			s.name = "render_mixed_8000";
+			s.bullet_count = 8000;
+			s.image = 2;
+			s.img_state_every = 4;
+			s.cull = true;
+			scenes.push_back(s);
+		}
+		return scenes;
+	}
+
+	std::string FormatResults(std::vector<SceneResult> const& results, uint32_t frames, uint32_t warmup)
+	{
+		std::string out;
+		out.append(fmt::format("{{\n  \"frames\": {},\n  \"warmup\": {},\n  \"scenes\": [\n", frames, warmup));
+		for (size_t i = 0; i < results.size(); i += 1)
+		{
+			auto const& r = results[i];
+			out.append(fmt::format("    {{\n      \"name\": \"{}\",\n      \"objects_begin\": {},\n      \"objects_end\": {},\n      \"churn_per_frame\": {},\n      \"phases\": {{\n",
+				r.scene->name, r.objects_begin, r.objects_end, r.scene->churn_per_frame));
+			double total_ns = 0.0;
+			bool first = true;
+			for (size_t p = 0; p < (size_t)Phase::Count; p += 1)
+			{
+				auto const& ph = r.phases[p];
+				if (ph.object_frames <= 0.0)
+					continue;
+				total_ns += ph.time_ns;
+				out.append(fmt::format("{}        \"{}\": {{ \"ns_per_object\": {:.3f}, \"ms_per_frame\": {:.4f} }}",
+					first ? "" : ",\n", PHASE_NAMES[p], ph.time_ns / ph.object_frames, ph.time_ns / 1.0e6 / (double)r.frames));
+				first = false;
+			}
+			out.append("\n      },\n");
+			if (r.scene->image != 0)
+			{
+				// 渲染统计，每帧平均
+				double const f = (double)r.frames;
+				out.append(fmt::format("      \"render\": {{ \"culled\": {:.1f}, \"batched\": {:.1f}, \"vertices\": {:.1f}, \"texture_switches\": {:.1f}, \"blend_switches\": {:.1f}, \"flushes\": {:.1f} }},\n",
+					(double)r.render_culled / f, (double)r.render_batched / f, (double)r.render.vertex / f,
+					(double)r.render.texture_switch / f, (double)r.render.blend_switch / f, (double)r.render.flush / f));
+			}
+			out.append(fmt::format("      \"total_ms_per_frame\": {:.4f}\n    }}{}\n",
+				total_ns / 1.0e6 / (double)r.frames, i + 1 < results.size() ? "," : ""));
+		}
+		out.append("  ]\n}\n");
+		return out;
+	}
+
+	bool ParseUInt(std::string_view arg, std::string_view option, uint32_t& out)
+	{
+		if (!arg.starts_with(option))
+			return false;
+		auto const value = arg.substr(option.size());
+		uint32_t v = 0;
+		auto const r = std::from_chars(value.data(), value.data() + value.size(), v);
+		if (r.ec == std::errc())
+			out = v;
+		else
+			std::fprintf(stderr, "benchmark: invalid command line argument '%.*s'\n", (int)arg.size(), arg.data());
+		return true;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Platform::CommandLineArguments::Get().Update(argc, argv);
+	spdlog::set_level(spdlog::level::warn);
+
+	uint32_t frames = 300;
+	uint32_t warmup = 30;
+	std::string filter;
+	std::string output;
+	{
+		constexpr std::string_view option_filter("--filter=");
+		constexpr std::string_view option_output("--output=");
+		std::vector<std::string_view> args;
+		Platform::CommandLineArguments::Get().GetArguments(args);
+		for (auto const& arg : args)
+		{
+			if (ParseUInt(arg, "--frames=", frames) || ParseUInt(arg, "--warmup=", warmup))
+				continue;
+			if (arg.starts_with(option_filter))
+				filter = arg.substr(option_filter.size());
+			else if (arg.starts_with(option_output))
+				output = arg.substr(option_output.size());
+		}
+		frames = std::max(frames, 1u);
+	}
+
+	Benchmark benchmark;
+	if (!benchmark.Initialize(frames, warmup))
+	{
+		benchmark.Shutdown();
+		return EXIT_FAILURE;
+	}
+	auto const scenes = MakeScenes();
+	std::vector<SceneResult> results;
+	for (auto const& scene : scenes)
+	{
+		if (!filter.empty() && scene.name.find(filter) == std::string::npos)
+			continue;
+		std::fprintf(stderr, "benchmark: running '%s'\n", scene.name.c_str());
+		SceneResult result;
+		if (!benchmark.Run(scene, result))
+		{
+			benchmark.Shutdown();
+			return EXIT_FAILURE;
+		}
+		results.push_back(result);
+	}
+	benchmark.Shutdown();
+
+	std::string const report = FormatResults(results, frames, warmup);
+	if (output.empty())
+	{
+		std::fputs(report.c_str(), stdout);
+		std::fflush(stdout);
+	}
+	else
+	{
+		std::ofstream file(std::filesystem::path(output), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			std::fprintf(stderr, "benchmark: can't open '%s'\n", output.c_str());
+			return EXIT_FAILURE;
+		}
+		file.write(report.data(), (std::streamsize)report.size());
+	}
+	return EXIT_SUCCESS;
+}
@@ -33,6 +33,8 @@ namespace LuaSTGPlus
                 LAPP.SetWindowed(!config.fullscreen_enable);
                 LAPP.SetVsync(config.vsync_enable);
                 LAPP.SetResolution(config.canvas_width, config.canvas_height);
+                if (config.object_pool_capacity > 0)
+                    LAPP.SetObjectPoolCapacity((uint32_t)config.object_pool_capacity);
                 is_launch_loaded = true;
             }
         }
@@ -604,6 +604,20 @@ static int lib_ShowFrameStatistics(lua_State* L)
                 ImGui::Text("Active : %llu", obj_info.object_alive);
                 ImGui::Text("Colli Check : %llu", obj_info.object_colli_check);
                 ImGui::Text("Colli Callback : %llu", obj_info.object_colli_callback);
+                ImGui::Text("Table Reuse : %llu", obj_info.object_table_reuse);
+                ImGui::Text("Render Culled : %llu", obj_info.object_render_culled);
+                ImGui::Text("Render Batched : %llu", obj_info.object_render_batched);
+                ImGui::Text("Step : Frame %.3fms, Bound %.3fms, Colli %.3fms, After %.3fms",
+                    obj_info.step_time[0], obj_info.step_time[1], obj_info.step_time[2], obj_info.step_time[3]);
+                if (obj_info.colli_pair_count > 0 && ImGui::TreeNode("Collision Pairs"))
+                {
+                    for (uint32_t i = 0; i < obj_info.colli_pair_count; i += 1)
+                    {
+                        auto const& pair = obj_info.colli_pair[i];
+                        ImGui::Text("%u - %u : Check %llu, Callback %llu, %.3fms", pair.group_a, pair.group_b, pair.check, pair.callback, pair.time);
+                    }
+                    ImGui::TreePop();
+                }
 
                 ImGui::SliderFloat("Timeline Height##GameObject", &height_2, 256.0f, 512.0f);
                 ImGui::Checkbox("Auto-Fit Y Axis##GameObject", &auto_fit_2);
@@ -122,6 +122,9 @@ namespace LuaSTGPlus
 
         group = 0;
         timer = ani_timer = 0;
+        motion = 0;
+        motion_timer = 0;
+        motion_angle = 0.0f;
 
         res = nullptr;
         ps = nullptr;
@@ -132,6 +135,9 @@ namespace LuaSTGPlus
     #endif
         ignore_superpause = false;
         touch_lastx_lasty = false;
+        no_cull = false;
+        swept = false;
+        warped = false;
 
         world = 15;
 
@@ -142,6 +148,7 @@ namespace LuaSTGPlus
 #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
         blendmode = BlendMode::MulAlpha;
         vertexcolor = 0xFFFFFFFF;
+        img_state = false;
 #endif // USING_ADVANCE_GAMEOBJECT_CLASS
     }
     void GameObject::DirtReset()
@@ -167,6 +174,9 @@ namespace LuaSTGPlus
 
         group = 0;
         timer = ani_timer = 0;
+        motion = 0;
+        motion_timer = 0;
+        motion_angle = 0.0f;
 
         ReleaseResource();
 
@@ -176,6 +186,9 @@ namespace LuaSTGPlus
     #endif
         ignore_superpause = false;
         touch_lastx_lasty = false;
+        no_cull = false;
+        swept = false;
+        warped = false;
 
         world = 15;
 
@@ -186,6 +199,7 @@ namespace LuaSTGPlus
 #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
         blendmode = BlendMode::MulAlpha;
         vertexcolor = 0xFFFFFFFF;
+        img_state = false;
 #endif // USING_ADVANCE_GAMEOBJECT_CLASS
     }
     
@@ -205,12 +219,31 @@ namespace LuaSTGPlus
         }
     }
     
+    Core::ScopeObject<IResourceBase> GameObject::FindResource(std::string_view const& res_name)
+    {
+        // 按图片、动画、粒子的顺序查找
+        Core::ScopeObject<IResourceBase> resource;
+        if (Core::ScopeObject<IResourceSprite> tSprite = LRES.FindSprite(res_name.data()))
+            resource = *tSprite;
+        else if (Core::ScopeObject<IResourceAnimation> tAnimation = LRES.FindAnimation(res_name.data()))
+            resource = *tAnimation;
+        else if (Core::ScopeObject<IResourceParticle> tParticle = LRES.FindParticle(res_name.data()))
+            resource = *tParticle;
+        return resource;
+    }
     bool GameObject::ChangeResource(std::string_view const& res_name)
     {
-        Core::ScopeObject<IResourceSprite> tSprite = LRES.FindSprite(res_name.data());
-        if (tSprite)
+        Core::ScopeObject<IResourceBase> resource = FindResource(res_name);
+        return resource && ChangeResource(*resource);
+    }
+    bool GameObject::ChangeResource(IResourceBase* resource)
+    {
+        switch (resource->GetType())
+        {
+        case ResourceType::Sprite:
         {
-            res = *tSprite;
+            IResourceSprite* tSprite = static_cast<IResourceSprite*>(resource);
+            res = tSprite;
             res->retain();
 #ifdef GLOBAL_SCALE_COLLI_SHAPE
             a = tSprite->GetHalfSizeX() * LRES.GetGlobalImageScaleFactor();
@@ -223,11 +256,10 @@ namespace LuaSTGPlus
             UpdateCollisionCircleRadius();
             return true;
         }
-
-        Core::ScopeObject<IResourceAnimation> tAnimation = LRES.FindAnimation(res_name.data());
-        if (tAnimation)
+        case ResourceType::Animation:
         {
-            res = *tAnimation;
+            IResourceAnimation* tAnimation = static_cast<IResourceAnimation*>(resource);
+            res = tAnimation;
             res->retain();
 #ifdef GLOBAL_SCALE_COLLI_SHAPE
             a = tAnimation->GetHalfSizeX() * LRES.GetGlobalImageScaleFactor();
@@ -240,10 +272,9 @@ namespace LuaSTGPlus
             UpdateCollisionCircleRadius();
             return true;
         }
-
-        Core::ScopeObject<IResourceParticle> tParticle = LRES.FindParticle(res_name.data());
-        if (tParticle)
+        case ResourceType::Particle:
         {
+            IResourceParticle* tParticle = static_cast<IResourceParticle*>(resource);
             // 分配粒子池
             if (!tParticle->CreateInstance(&ps))
             {
@@ -256,7 +287,7 @@ namespace LuaSTGPlus
             ps->SetRotation((float)rot);
             ps->SetActive(true);
             // 设置资源
-            res = *tParticle;
+            res = tParticle;
             res->retain();
 #ifdef GLOBAL_SCALE_COLLI_SHAPE
             a = tParticle->GetHalfSizeX() * LRES.GetGlobalImageScaleFactor();
@@ -269,8 +300,9 @@ namespace LuaSTGPlus
             UpdateCollisionCircleRadius();
             return true;
         }
-
-        return false;
+        default:
+            return false;
+        }
     }
     void GameObject::ReleaseResource()
     {
@@ -285,6 +317,9 @@ namespace LuaSTGPlus
             res->release();
             res = nullptr;
         }
+    #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+        img_state = false; // SetImgState 设置的状态跟随图片资源
+    #endif // USING_ADVANCE_GAMEOBJECT_CLASS
     }
     void GameObject::ChangeLuaRC(lua_State* L, int idx)
     {
@@ -406,6 +441,7 @@ namespace LuaSTGPlus
         lastx = x;
         lasty = y;
         touch_lastx_lasty = true;
+        warped = false;
         if (navi && (std::abs(dx) > std::numeric_limits<double>::min() || std::abs(dy) > std::numeric_limits<double>::min()))
         {
             rot = std::atan2(dy, dx);
@@ -423,7 +459,7 @@ namespace LuaSTGPlus
         {
             float const gscale = LRES.GetGlobalImageScaleFactor();
         #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
-            if (!luaclass.IsRenderClass)
+            if (!HasImgState())
             {
         #endif // USING_ADVANCE_GAMEOBJECT_CLASS
                 switch (res->GetType())
@@ -505,6 +541,67 @@ namespace LuaSTGPlus
         }
     }
     
+    // 不是对象属性的键直接保存到对象 table 中，对象 table 在栈上的位置为 1
+    static void _RawSetMember(lua_State* L, int ki, int vi)
+    {
+        lua_pushvalue(L, ki);
+        lua_pushvalue(L, vi);
+        lua_rawset(L, 1);
+    }
+
+    std::string const& GameObject::GetViewDeclaration()
+    {
+        static_assert(std::is_same_v<decltype(GameObject::x), float> && std::is_same_v<decltype(GameObject::rot), float>);
+        static_assert(std::is_same_v<lua_Integer, ptrdiff_t>);
+        static std::string const declaration = []
+        {
+            struct Field
+            {
+                size_t offset;
+                size_t size;
+                std::string_view decl;
+            };
+        #define FIELD(NAME, DECL) Field{ offsetof(GameObject, NAME), sizeof(GameObject::NAME), DECL }
+            std::vector<Field> fields = {
+                FIELD(status, "const uint32_t status;"),
+                FIELD(uid, "const uint64_t uid;"),
+                FIELD(x, "float x;"),
+                FIELD(y, "float y;"),
+                FIELD(dx, "const float dx;"),
+                FIELD(dy, "const float dy;"),
+                FIELD(vx, "float vx;"),
+                FIELD(vy, "float vy;"),
+                FIELD(ax, "float ax;"),
+                FIELD(ay, "float ay;"),
+                FIELD(hscale, "float hscale;"),
+                FIELD(vscale, "float vscale;"),
+                FIELD(rot, "float rot;"),
+                FIELD(omega, "float omega;"),
+                FIELD(ani_timer, "const ptrdiff_t ani_timer;"),
+                FIELD(timer, "ptrdiff_t timer;"),
+            };
+        #undef FIELD
+            std::sort(fields.begin(), fields.end(), [](Field const& a, Field const& b) { return a.offset < b.offset; });
+            // 不公开的字段用填充数组占位
+            std::string s("typedef struct lstg_GameObjectView {\n");
+            size_t offset = 0;
+            int padding = 0;
+            for (auto const& f : fields)
+            {
+                if (f.offset > offset)
+                {
+                    s.append(fmt::format("    uint8_t _{}[{}];\n", padding, f.offset - offset));
+                    padding += 1;
+                }
+                s.append("    ").append(f.decl).append("\n");
+                offset = f.offset + f.size;
+            }
+            s.append("} lstg_GameObjectView;\n");
+            return s;
+        }();
+        return declaration;
+    }
+
     int GameObject::GetAttr(lua_State* L)
     {
     #define return_default(L) lua_rawget(L, 1)
@@ -730,6 +827,12 @@ namespace LuaSTGPlus
         case LuaSTG::GameObjectMember::IGNORESUPERPAUSE:
             lua_pushboolean(L, ignore_superpause);
             return 1;
+        case LuaSTG::GameObjectMember::NOCULL:
+            lua_pushboolean(L, no_cull);
+            return 1;
+        case LuaSTG::GameObjectMember::SWEPT:
+            lua_pushboolean(L, swept);
+            return 1;
         
         default:
             return_default(L);
@@ -742,13 +845,18 @@ namespace LuaSTGPlus
     {
         // self k v
         std::string_view const key = luaL_check_string_view(L, 2);
-        switch (LuaSTG::MapGameObjectMember(key.data()))
+        return SetMember(L, LuaSTG::MapGameObjectMember(key.data()), 2, 3);
+    }
+    int GameObject::SetMember(lua_State* L, LuaSTG::GameObjectMember member, int ki, int vi)
+    {
+        // self ... k ... v ...
+        switch (member)
         {
             // 基本信息
 
         case LuaSTG::GameObjectMember::STATUS:
             do {
-                std::string_view const value = luaL_check_string_view(L, 3);
+                std::string_view const value = luaL_check_string_view(L, vi);
                 if (value == "normal")
                     status = GameObjectStatus::Active;
                 else if (value == "del")
@@ -762,28 +870,31 @@ namespace LuaSTGPlus
         case LuaSTG::GameObjectMember::CLASS:
             do {
             #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
-                if (!GameObjectClass::CheckClassValid(L, 3))
+                if (!GameObjectClass::CheckClassValid(L, vi))
                     return luaL_error(L, "invalid argument for property 'class', required luastg object class.");
-                luaclass.CheckClassClass(L, 3); // 刷新对象的class
+                luaclass.CheckClassClass(L, vi); // 刷新对象的class
                 if (!luaclass.IsRenderClass) ReleaseLuaRC(L, 1); // 你怎么回事，还给变回去了，那就释放资源
             #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+                lua_pushvalue(L, vi);
                 lua_rawseti(L, 1, 1);
             } while (false);
-            return 0;
+            return 3;
             
             // 分组
 
         case LuaSTG::GameObjectMember::WORLD:
-            world = luaL_checkinteger(L, 3);
+            world = luaL_checkinteger(L, vi);
             return 0;
 
             // 位置
 
         case LuaSTG::GameObjectMember::X:
-            x = luaL_checknumber(L, 3);
+            x = luaL_checknumber(L, vi);
+            warped = true;
             return 0;
         case LuaSTG::GameObjectMember::Y:
-            y = luaL_checknumber(L, 3);
+            y = luaL_checknumber(L, vi);
+            warped = true;
             return 0;
         case LuaSTG::GameObjectMember::DX:
             return luaL_error(L, "property 'dx' is readonly.");
@@ -793,35 +904,35 @@ namespace LuaSTGPlus
             // 运动学
 
         case LuaSTG::GameObjectMember::VX:
-            vx = luaL_checknumber(L, 3);
+            vx = luaL_checknumber(L, vi);
             return 0;
         case LuaSTG::GameObjectMember::VY:
-            vy = luaL_checknumber(L, 3);
+            vy = luaL_checknumber(L, vi);
             return 0;
         case LuaSTG::GameObjectMember::AX:
-            ax = luaL_checknumber(L, 3);
+            ax = luaL_checknumber(L, vi);
             return 0;
         case LuaSTG::GameObjectMember::AY:
-            ay = luaL_checknumber(L, 3);
+            ay = luaL_checknumber(L, vi);
             return 0;
         #ifdef USER_SYSTEM_OPERATION
         case LuaSTG::GameObjectMember::MAXVX:
-            maxvx = std::abs(luaL_checknumber(L, 3));
+            maxvx = std::abs(luaL_checknumber(L, vi));
             return 0;
         case LuaSTG::GameObjectMember::MAXVY:
-            maxvy = std::abs(luaL_checknumber(L, 3));
+            maxvy = std::abs(luaL_checknumber(L, vi));
             return 0;
         case LuaSTG::GameObjectMember::MAXV:
-            maxv = luaL_checknumber(L, 3);
+            maxv = luaL_checknumber(L, vi);
             return 0;
         case LuaSTG::GameObjectMember::AG:
-            ag = luaL_checknumber(L, 3);
+            ag = luaL_checknumber(L, vi);
             return 0;
         #endif
         case LuaSTG::GameObjectMember::VSPEED:
             do {
                 lua_Number const cur_speed_ = std::sqrt(vx * vx + vy * vy);
-                lua_Number const new_speed_ = luaL_checknumber(L, 3);
+                lua_Number const new_speed_ = luaL_checknumber(L, vi);
                 if (cur_speed_ <= std::numeric_limits<double>::min())
                 {
                     vx = std::cos(rot) * new_speed_;
@@ -838,7 +949,7 @@ namespace LuaSTGPlus
         case LuaSTG::GameObjectMember::VANGLE:
             do {
                 lua_Number const cur_speed_ = std::sqrt(vx * vx + vy * vy);
-                lua_Number const new_angle_ = luaL_checknumber(L, 3) * L_DEG_TO_RAD;
+                lua_Number const new_angle_ = luaL_checknumber(L, vi) * L_DEG_TO_RAD;
                 if (cur_speed_ <= std::numeric_limits<double>::min())
                 {
                     rot = new_angle_;
@@ -852,32 +963,33 @@ namespace LuaSTGPlus
             return 0;  
         case LuaSTG::GameObjectMember::VPOS:
             {
-                Core::Vector2F* const pos = LuaWrapper::Vector2Wrapper::Cast(L, 3);
+                Core::Vector2F* const pos = LuaWrapper::Vector2Wrapper::Cast(L, vi);
                 x = pos->x;
                 y = pos->y;
+                warped = true;
             } return 0;
         case LuaSTG::GameObjectMember::VVEL:
             {
-                Core::Vector2F* const vel = LuaWrapper::Vector2Wrapper::Cast(L, 3);
+                Core::Vector2F* const vel = LuaWrapper::Vector2Wrapper::Cast(L, vi);
                 vx = vel->x;
                 vy = vel->y;
             } return 0;
         case LuaSTG::GameObjectMember::VACCEL:
             {
-                Core::Vector2F* const accel = LuaWrapper::Vector2Wrapper::Cast(L, 3);
+                Core::Vector2F* const accel = LuaWrapper::Vector2Wrapper::Cast(L, vi);
                 ax = accel->x;
                 ay = accel->y;
             } return 0;
         case LuaSTG::GameObjectMember::VVSCALE:
             {
-                Core::Vector2F* const scale = LuaWrapper::Vector2Wrapper::Cast(L, 3);
+                Core::Vector2F* const scale = LuaWrapper::Vector2Wrapper::Cast(L, vi);
                 hscale = scale->x;
                 vscale = scale->y;
             } return 0;
 
         case LuaSTG::GameObjectMember::GROUP:
             do {
-                lua_Integer const group_ = luaL_checkinteger(L, 3);
+                lua_Integer const group_ = luaL_checkinteger(L, vi);
                 if (group == group_)
                     return 0;
                 if (0 <= group_ && group_ < LOBJPOOL_GROUPN)
@@ -887,28 +999,28 @@ namespace LuaSTGPlus
             } while (false);
             return 1;
         case LuaSTG::GameObjectMember::BOUND:
-            bound = lua_to_uint8_boolean(L, 3);
+            bound = lua_to_uint8_boolean(L, vi);
             return 0;
         case LuaSTG::GameObjectMember::COLLI:
-            colli = lua_to_uint8_boolean(L, 3);
+            colli = lua_to_uint8_boolean(L, vi);
             return 0;
         case LuaSTG::GameObjectMember::RECT:
-            rect = lua_to_uint8_boolean(L, 3);
+            rect = lua_to_uint8_boolean(L, vi);
             UpdateCollisionCircleRadius();
             return 0;
         case LuaSTG::GameObjectMember::A:
         #ifdef GLOBAL_SCALE_COLLI_SHAPE
-            a = luaL_checknumber(L, 3) * LRES.GetGlobalImageScaleFactor();
+            a = luaL_checknumber(L, vi) * LRES.GetGlobalImageScaleFactor();
         #else
-            a = luaL_checknumber(L, 3);
+            a = luaL_checknumber(L, vi);
         #endif // GLOBAL_SCALE_COLLI_SHAPE
             UpdateCollisionCircleRadius();
             return 0;
         case LuaSTG::GameObjectMember::B:
         #ifdef GLOBAL_SCALE_COLLI_SHAPE
-            b = luaL_checknumber(L, 3) * LRES.GetGlobalImageScaleFactor();
+            b = luaL_checknumber(L, vi) * LRES.GetGlobalImageScaleFactor();
         #else
-            b = luaL_checknumber(L, 3);
+            b = luaL_checknumber(L, vi);
         #endif // GLOBAL_SCALE_COLLI_SHAPE
             UpdateCollisionCircleRadius();
             return 0;
@@ -918,78 +1030,78 @@ namespace LuaSTGPlus
         case LuaSTG::GameObjectMember::LAYER:
             do
             {
-                lua_Number const layer_ = luaL_checknumber(L, 3);
+                lua_Number const layer_ = luaL_checknumber(L, vi);
                 if (layer == layer_)
                     return 0;
                 nextlayer = layer_;
             } while (false);
             return 2;
         case LuaSTG::GameObjectMember::HSCALE:
-            hscale = luaL_checknumber(L, 3);
+            hscale = luaL_checknumber(L, vi);
             return 0;
         case LuaSTG::GameObjectMember::VSCALE:
-            vscale = luaL_checknumber(L, 3);
+            vscale = luaL_checknumber(L, vi);
             return 0;
         case LuaSTG::GameObjectMember::ROT:
-            rot = luaL_checknumber(L, 3) * L_DEG_TO_RAD;
+            rot = luaL_checknumber(L, vi) * L_DEG_TO_RAD;
             return 0;
         case LuaSTG::GameObjectMember::OMEGA:
-            omega = luaL_checknumber(L, 3) * L_DEG_TO_RAD;
+            omega = luaL_checknumber(L, vi) * L_DEG_TO_RAD;
             return 0;
         #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
         case LuaSTG::GameObjectMember::_BLEND:
             if (luaclass.IsRenderClass)
-                blendmode = TranslateBlendMode(L, 3);
+                blendmode = TranslateBlendMode(L, vi);
             else
-                lua_rawset(L, 1);
+                _RawSetMember(L, ki, vi);
             return 0;
         case LuaSTG::GameObjectMember::_COLOR:
             if (luaclass.IsRenderClass)
             {
-                vertexcolor = LuaWrapper::ColorWrapper::Cast(L, 3)->color();
+                vertexcolor = LuaWrapper::ColorWrapper::Cast(L, vi)->color();
                 vertexcolor = ((vertexcolor & 0xFF00FF00) + ((vertexcolor & 0xFF0000) >> 16) + ((vertexcolor & 0xFF) << 16));
             }
             else
-                lua_rawset(L, 1);
+                _RawSetMember(L, ki, vi);
             return 0;
         case LuaSTG::GameObjectMember::_A:
             if (luaclass.IsRenderClass)
-                ((uint8_t*)&vertexcolor)[3] = (uint8_t)luaL_checkinteger(L, 3);
+                ((uint8_t*)&vertexcolor)[3] = (uint8_t)luaL_checkinteger(L, vi);
             else
-                lua_rawset(L, 1);
+                _RawSetMember(L, ki, vi);
             return 0;
         case LuaSTG::GameObjectMember::_R:
             if (luaclass.IsRenderClass)
-                ((uint8_t*)&vertexcolor)[2] = (uint8_t)luaL_checkinteger(L, 3);
+                ((uint8_t*)&vertexcolor)[2] = (uint8_t)luaL_checkinteger(L, vi);
             else
-                lua_rawset(L, 1);
+                _RawSetMember(L, ki, vi);
             return 0;
         case LuaSTG::GameObjectMember::_G:
             if (luaclass.IsRenderClass)
-                ((uint8_t*)&vertexcolor)[1] = (uint8_t)luaL_checkinteger(L, 3);
+                ((uint8_t*)&vertexcolor)[1] = (uint8_t)luaL_checkinteger(L, vi);
             else
-                lua_rawset(L, 1);
+                _RawSetMember(L, ki, vi);
             return 0;
         case LuaSTG::GameObjectMember::_B:
             if (luaclass.IsRenderClass)
-                ((uint8_t*)&vertexcolor)[0] = (uint8_t)luaL_checkinteger(L, 3);
+                ((uint8_t*)&vertexcolor)[0] = (uint8_t)luaL_checkinteger(L, vi);
             else
-                lua_rawset(L, 1);
+                _RawSetMember(L, ki, vi);
             return 0;
         #endif // USING_ADVANCE_GAMEOBJECT_CLASS
         case LuaSTG::GameObjectMember::ANI:
             return luaL_error(L, "property 'ani' is readonly.");
         case LuaSTG::GameObjectMember::HIDE:
-            hide = lua_to_uint8_boolean(L, 3);
+            hide = lua_to_uint8_boolean(L, vi);
             return 0;
         case LuaSTG::GameObjectMember::NAVI:
-            navi = lua_to_uint8_boolean(L, 3);
+            navi = lua_to_uint8_boolean(L, vi);
             return 0;
         case LuaSTG::GameObjectMember::IMG:
             do {
-                if (lua_isstring(L, 3))
+                if (lua_isstring(L, vi))
                 {
-                    std::string_view const value = luaL_check_string_view(L, 3);
+                    std::string_view const value = luaL_check_string_view(L, vi);
                     if (!res || value != res->GetResName())
                     {
                         ReleaseLuaRC(L, 1); // TODO: 默认 table 是第一个？
@@ -1011,54 +1123,44 @@ namespace LuaSTGPlus
             if (luaclass.IsRenderClass)
                 return luaL_error(L, "property 'rc' is readonly.");
             else
-                lua_rawset(L, 1);
+                _RawSetMember(L, ki, vi);
             return 0;
         #endif // USING_ADVANCE_GAMEOBJECT_CLASS
 
             // 更新控制
 
         case LuaSTG::GameObjectMember::TIMER:
-            timer = luaL_checkinteger(L, 3);
+            timer = luaL_checkinteger(L, vi);
             return 0;
         #ifdef	LUASTG_ENABLE_GAME_OBJECT_PROPERTY_PAUSE
         case LuaSTG::GameObjectMember::PAUSE:
-            pause = luaL_checkinteger(L, 3);
+            pause = luaL_checkinteger(L, vi);
             return 0;
         case LuaSTG::GameObjectMember::RESOLVEMOVE:
-            resolve_move = lua_to_uint8_boolean(L, 3);
+            resolve_move = lua_to_uint8_boolean(L, vi);
             return 0;
         #endif
         case LuaSTG::GameObjectMember::IGNORESUPERPAUSE:
-            ignore_superpause = lua_to_uint8_boolean(L, 3);
+            ignore_superpause = lua_to_uint8_boolean(L, vi);
+            return 0;
+        case LuaSTG::GameObjectMember::NOCULL:
+            no_cull = lua_to_uint8_boolean(L, vi);
+            return 0;
+        case LuaSTG::GameObjectMember::SWEPT:
+            swept = lua_to_uint8_boolean(L, vi);
             return 0;
         
             // 默认处理
 
         default:
-            lua_rawset(L, 1);
+            _RawSetMember(L, ki, vi);
             return 0;
         }
     }
 
-    bool CollisionCheck(GameObject* p1, GameObject* p2) noexcept
+    // 外接圆和精确碰撞检测，对象使用指定的坐标
+    static bool _CollisionCheckAt(GameObject const* p1, float x1, float y1, GameObject const* p2, float x2, float y2) noexcept
     {
-        //忽略不碰撞对象
-        if (!p1->colli || !p2->colli)
-            return false;//返回点0
-        
-        //快速AABB检测
-        if ((p1->x - p1->col_r >= p2->x + p2->col_r) ||
-            (p1->x + p1->col_r <= p2->x - p2->col_r) ||
-            (p1->y - p1->col_r >= p2->y + p2->col_r) ||
-            (p1->y + p1->col_r <= p2->y - p2->col_r))
-        {
-            return false;
-        }
-        
-        float x1 = (float)p1->x;
-        float x2 = (float)p2->x;
-        float y1 = (float)p1->y;
-        float y2 = (float)p2->y;
         float a1 = (float)p1->a;
         float a2 = (float)p2->a;
         float b1 = (float)p1->b;
@@ -1104,4 +1206,138 @@ namespace LuaSTGPlus
         }
         return false;
     }
+
+    // 连续碰撞检测每对对象最多采样的次数，只用于无法解析计算的形状
+    static constexpr int MAX_SWEPT_SAMPLES = 64;
+
+    // 线段 s + d * t（t 属于 [0, 1]）是否与中心在原点、半宽为 hx、hy 的轴对齐矩形相交
+    static bool _SegmentIntersectsBox(float sx, float sy, float dx, float dy, float hx, float hy) noexcept
+    {
+        float t0 = 0.0f;
+        float t1 = 1.0f;
+        auto const slab = [&](float s, float d, float h) -> bool
+        {
+            if (d == 0.0f)
+                return -h <= s && s <= h;
+            float ta = (-h - s) / d;
+            float tb = (h - s) / d;
+            if (ta > tb)
+                std::swap(ta, tb);
+            t0 = std::max(t0, ta);
+            t1 = std::min(t1, tb);
+            return t0 <= t1;
+        };
+        return slab(sx, dx, hx) && slab(sy, dy, hy);
+    }
+
+    // 线段 s + d * t（t 属于 [0, 1]）是否与圆心在 (px, py)、半径为 r 的圆相交
+    static bool _SegmentIntersectsCircle(float sx, float sy, float dx, float dy, float px, float py, float r) noexcept
+    {
+        float const ox = sx - px;
+        float const oy = sy - py;
+        float const dd = dx * dx + dy * dy;
+        float const t = dd > 0.0f ? std::clamp(-(ox * dx + oy * dy) / dd, 0.0f, 1.0f) : 0.0f;
+        float const cx = ox + dx * t;
+        float const cy = oy + dy * t;
+        return cx * cx + cy * cy <= r * r;
+    }
+
+    // 连续碰撞检测
+    // 以 p2 为参考系，p1 的相对位置从 s 线性移动到 s + d，两个对象的旋转保持当前值
+    static bool _SweptCollisionCheck(GameObject const* p1, GameObject const* p2) noexcept
+    {
+        float const d1x = p1->IsSweeping() ? (p1->x - p1->lastx) : 0.0f;
+        float const d1y = p1->IsSweeping() ? (p1->y - p1->lasty) : 0.0f;
+        float const d2x = p2->IsSweeping() ? (p2->x - p2->lastx) : 0.0f;
+        float const d2y = p2->IsSweeping() ? (p2->y - p2->lasty) : 0.0f;
+        float const dx = d1x - d2x;
+        float const dy = d1y - d2y;
+        float const sx = (p1->x - p2->x) - dx;
+        float const sy = (p1->y - p2->y) - dy;
+        float const dd = dx * dx + dy * dy;
+
+        // 外接圆扫过的胶囊体与另一个外接圆的检测，即线段到圆心的最近距离
+        float t = 0.0f;
+        if (dd > 0.0f)
+        {
+            t = std::clamp(-(sx * dx + sy * dy) / dd, 0.0f, 1.0f);
+        }
+        float const cx = sx + dx * t;
+        float const cy = sy + dy * t;
+        float const cr = p1->col_r + p2->col_r;
+        if (cx * cx + cy * cy > cr * cr)
+            return false;
+
+        // 两个都是圆时胶囊体检测就是精确结果
+        bool const circle1 = !p1->rect && p1->a == p1->b;
+        bool const circle2 = !p2->rect && p2->a == p2->b;
+        if (circle1 && circle2)
+        {
+            float const r = p1->a + p2->a;
+            return cx * cx + cy * cy <= r * r;
+        }
+
+        // 圆与矩形、朝向相同的两个矩形：转到矩形的局部坐标系后，
+        // 是线段与两个矩形的闵可夫斯基和（矩形或圆角矩形）的相交检测，同样是精确结果
+        if ((circle1 && p2->rect) || (p1->rect && circle2) || (p1->rect && p2->rect && p1->rot == p2->rot))
+        {
+            GameObject const* box = p2->rect ? p2 : p1;
+            float const sign = (box == p2) ? 1.0f : -1.0f; // 以矩形为参考系
+            float const c = std::cos((float)box->rot);
+            float const s = std::sin((float)box->rot);
+            float const lsx = sign * (sx * c + sy * s);
+            float const lsy = sign * (sy * c - sx * s);
+            float const ldx = sign * (dx * c + dy * s);
+            float const ldy = sign * (dy * c - dx * s);
+            if (p1->rect && p2->rect)
+            {
+                return _SegmentIntersectsBox(lsx, lsy, ldx, ldy, p1->a + p2->a, p1->b + p2->b);
+            }
+            float const r = (box == p2) ? p1->a : p2->a;
+            float const hx = box->a;
+            float const hy = box->b;
+            return _SegmentIntersectsBox(lsx, lsy, ldx, ldy, hx + r, hy)
+                || _SegmentIntersectsBox(lsx, lsy, ldx, ldy, hx, hy + r)
+                || _SegmentIntersectsCircle(lsx, lsy, ldx, ldy, hx, hy, r)
+                || _SegmentIntersectsCircle(lsx, lsy, ldx, ldy, -hx, hy, r)
+                || _SegmentIntersectsCircle(lsx, lsy, ldx, ldy, hx, -hy, r)
+                || _SegmentIntersectsCircle(lsx, lsy, ldx, ldy, -hx, -hy, r);
+        }
+
+        // 其他形状（椭圆、朝向不同的矩形）沿线段采样，间隔不超过两个碰撞体中较小的半宽；
+        // 采样次数最多为 MAX_SWEPT_SAMPLES，移动距离超过该次数的半宽时，薄的碰撞体仍可能被跳过
+        float const step = std::max(std::min(std::min(p1->a, p1->b), std::min(p2->a, p2->b)), 0.5f);
+        int const n = std::clamp((int)std::ceil(std::sqrt(dd) / step), 1, MAX_SWEPT_SAMPLES);
+        // 先检测最近点，再从当前坐标往回检测
+        if (_CollisionCheckAt(p1, p2->x + cx, p2->y + cy, p2, p2->x, p2->y))
+            return true;
+        for (int i = n; i >= 0; i -= 1)
+        {
+            float const ti = (float)i / (float)n;
+            if (_CollisionCheckAt(p1, p2->x + sx + dx * ti, p2->y + sy + dy * ti, p2, p2->x, p2->y))
+                return true;
+        }
+        return false;
+    }
+
+    bool CollisionCheck(GameObject* p1, GameObject* p2) noexcept
+    {
+        //忽略不碰撞对象
+        if (!p1->colli || !p2->colli)
+            return false;//返回点0
+        
+        if (p1->IsSweeping() || p2->IsSweeping())
+            return _SweptCollisionCheck(p1, p2);
+        
+        //快速AABB检测
+        if ((p1->x - p1->col_r >= p2->x + p2->col_r) ||
+            (p1->x + p1->col_r <= p2->x - p2->col_r) ||
+            (p1->y - p1->col_r >= p2->y + p2->col_r) ||
+            (p1->y + p1->col_r <= p2->y - p2->col_r))
+        {
+            return false;
+        }
+        
+        return _CollisionCheckAt(p1, (float)p1->x, (float)p1->y, p2, (float)p2->x, (float)p2->y);
+    }
 }
@@ -2,6 +2,7 @@
 #include "GameResource/ResourceBase.hpp"
 #include "GameResource/ResourceParticle.hpp"
 #include "GameObject/GameObjectClass.hpp"
+#include "LuaBinding/lua_luastg_hash.hpp"
 #include "lua.hpp"
 
 namespace LuaSTGPlus
@@ -99,25 +100,43 @@ namespace LuaSTGPlus
 		lua_Integer pause;				// [P] 对象被暂停的时间(帧) 对象被暂停时，将跳过速度计算，但是timer会增加，frame仍会调用
 		// uint8_t resolve_move;			// [1] 是否为计算速度而非计算位置
 	#endif
+		// 运动程序
+
+		uint32_t motion;				// [4] 运动程序序号，0 表示没有
+		int32_t motion_timer;			// [4] [不可见] 运动程序计时器
+		float motion_angle;				// [4] [不可见] 运动程序记录的方向（角度制），速度为 0 时用于保持方向
+
 		// uint8_t ignore_superpause;		// [1] 是否无视超级暂停。 超级暂停时，timer不会增加，frame不会调用，但render会调用。
 		// uint8_t touch_lastx_lasty;		// [1] 是否已经更新过 lastx 和 lasty 值，如果未更新过，表明对象刚生成，获取 dx 和 dy 时应当返回 0
+		// uint8_t no_cull;				// [1] 是否不参与渲染剔除，自行绘制到其他位置的对象需要设置
+		// uint8_t img_state;				// [1] 是否使用对象自己的混合模式和顶点颜色，由 SetImgState 设置
+		// uint8_t swept;					// [1] 是否进行连续碰撞检测，检测从上一帧坐标到当前坐标扫过的范围
+		//									//     只有 vx、vy 等运动学属性产生的位移会被检测；在 frame 回调等处给 x、y、vpos 赋值视为瞬移，
+		//									//     这一帧不检测扫过的范围，需要连续碰撞检测的对象应当通过速度移动
+		// uint8_t warped;					// [1] [不可见] 坐标是否在这一帧被直接赋值（x、y、vpos），瞬移时不进行连续碰撞检测
 
 		union
 		{
 			struct
 			{
-				uint8_t bound : 1;
-				uint8_t colli : 1;
-				uint8_t rect : 1;
-				uint8_t hide : 1;
-				uint8_t navi : 1;
-				uint8_t ignore_superpause : 1;
-				uint8_t touch_lastx_lasty : 1;
+				uint16_t bound : 1;
+				uint16_t colli : 1;
+				uint16_t rect : 1;
+				uint16_t hide : 1;
+				uint16_t navi : 1;
+				uint16_t ignore_superpause : 1;
+				uint16_t touch_lastx_lasty : 1;
 #ifdef LUASTG_ENABLE_GAME_OBJECT_PROPERTY_PAUSE
-				uint8_t resolve_move : 1;
+				uint16_t resolve_move : 1;
 #endif
+				uint16_t no_cull : 1; // 不参与渲染剔除
+#ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+				uint16_t img_state : 1; // 使用对象自己的图像状态
+#endif
+				uint16_t swept : 1; // 连续碰撞检测
+				uint16_t warped : 1; // 坐标在这一帧被直接赋值（瞬移），不检测扫过的范围，UpdateXY 后清除
 			};
-			uint8_t __Flags{};
+			uint16_t __Flags{};
 		};
 	
 
@@ -127,6 +146,9 @@ namespace LuaSTGPlus
 		void DirtReset();
 		void UpdateCollisionCircleRadius();
 		bool ChangeResource(std::string_view const& res_name);
+		bool ChangeResource(IResourceBase* resource);
+		// 按名称查找对象可以使用的资源（图片、动画、粒子），找不到时返回空
+		static Core::ScopeObject<IResourceBase> FindResource(std::string_view const& res_name);
 		void ChangeLuaRC(lua_State* L, int idx);
 		void ReleaseResource();
 		void ReleaseLuaRC(lua_State* L, int idx);
@@ -138,6 +160,45 @@ namespace LuaSTGPlus
 
 		int GetAttr(lua_State* L);
 		int SetAttr(lua_State* L);
+		// 设置属性，对象 table 在栈上的位置为 1，ki、vi 为键和值在栈上的位置；返回值与 SetAttr 相同：
+		// 1 碰撞组改变，2 图层改变，3 类改变，由调用者更新对象池
+		int SetMember(lua_State* L, LuaSTG::GameObjectMember member, int ki, int vi);
+
+		// LuaJIT FFI 对象视图 lstg_GameObjectView 的 C 声明，字段偏移与本结构体相同，通过对象 table 第 3 项的指针访问；
+		// 只包含修改后不需要额外处理的字段，rot、omega 为弧度制；
+		// 视图指向对象池的槽位，对象回收、复用或整理对象池后指向其他对象，需要用 uid 检查；
+		// 通过视图修改坐标不会使碰撞检测和空间查询的网格失效，同一帧内两次碰撞检测或查询之间移动对象应使用 table 接口或 lstg.InvalidateCollisionGroup
+		static std::string const& GetViewDeclaration();
+
+	#ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+		// 渲染时使用对象的 blendmode 和 vertexcolor，而不是资源的混合模式和顶点颜色
+		inline bool HasImgState() const noexcept
+		{
+			return luaclass.IsRenderClass || img_state;
+		}
+	#endif // USING_ADVANCE_GAMEOBJECT_CLASS
+
+		// 是否需要检测从 (lastx, lasty) 到 (x, y) 扫过的范围，刚创建的对象还没有上一帧坐标，瞬移的对象没有经过中间的位置
+		inline bool IsSweeping() const noexcept
+		{
+			return swept && !warped && touch_lastx_lasty && (lastx != x || lasty != y);
+		}
+
+		// 碰撞体外接矩形，连续碰撞检测的对象包含整个扫过的范围
+		inline void GetColliderBound(float& l, float& r, float& b_, float& t) const noexcept
+		{
+			l = x - col_r;
+			r = x + col_r;
+			b_ = y - col_r;
+			t = y + col_r;
+			if (IsSweeping())
+			{
+				l = std::min(l, lastx - col_r);
+				r = std::max(r, lastx + col_r);
+				b_ = std::min(b_, lasty - col_r);
+				t = std::max(t, lasty + col_r);
+			}
+		}
 
 		inline bool IsInRect(lua_Number l, lua_Number r, lua_Number b_, lua_Number t) const noexcept
 		{
@@ -1,5 +1,6 @@
 ﻿#include "GameObject/GameObjectBentLaser.hpp"
 #include "AppFrame.h"
+#include "GameObject/GameObjectSnapshot.hpp"
 
 using namespace LuaSTGPlus;
 
@@ -1038,3 +1039,47 @@ int GameObjectBentLaser::api_UpdateAllNodeByList(lua_State* L)
 
 	return 0;
 }
+
+void GameObjectBentLaser::SaveState(std::string& out)
+{
+	GameObjectSnapshotWriter w(out);
+	w.Write(m_Queue.Size());
+	for (size_t i = 0; i < m_Queue.Size(); i += 1)
+	{
+		w.Write(m_Queue[i]);
+	}
+	w.Write(m_fLength);
+	w.Write(m_fEnvelopeHeight);
+	w.Write(m_fEnvelopeBase);
+	w.Write(m_fEnvelopeRate);
+	w.Write(m_fEnvelopePower);
+}
+
+bool GameObjectBentLaser::LoadState(std::string_view const& data) noexcept
+{
+	// 先读到临时变量，数据无效时不修改激光
+	GameObjectSnapshotReader r(data);
+	size_t size = 0;
+	if (!r.Read(size) || size > m_Queue.Capacity())
+		return false;
+	std::array<LaserNode, LGOBJ_MAXLASERNODE> nodes;
+	for (size_t i = 0; i < size; i += 1)
+	{
+		if (!r.Read(nodes[i], { offsetof(LaserNode, active), offsetof(LaserNode, sharp) }))
+			return false;
+	}
+	float length = 0.0f, height = 0.0f, base = 0.0f, rate = 0.0f, power = 0.0f;
+	if (!r.Read(length) || !r.Read(height) || !r.Read(base) || !r.Read(rate) || !r.Read(power) || !r.IsEnd())
+		return false;
+	m_Queue.Clear();
+	for (size_t i = 0; i < size; i += 1)
+	{
+		m_Queue.PlacementPushTail() = nodes[i];
+	}
+	m_fLength = length;
+	m_fEnvelopeHeight = height;
+	m_fEnvelopeBase = base;
+	m_fEnvelopeRate = rate;
+	m_fEnvelopePower = power;
+	return true;
+}
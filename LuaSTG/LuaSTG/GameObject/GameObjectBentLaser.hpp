@@ -61,6 +61,9 @@ namespace LuaSTGPlus
 		void SetEnvelope(float height, float base, float rate, float power) noexcept; // 设置碰撞包络
 		bool BoundCheck() noexcept; // 检查是否离开边界
 		bool CollisionCheck(float x, float y, float rot, float a, float b, bool rect) noexcept; // 碰撞检测
+		// 快照，保存和恢复节点与碰撞包络
+		void SaveState(std::string& out);
+		bool LoadState(std::string_view const& data) noexcept;
 		// 即将被废弃
 		bool UpdateByNode(size_t id, int node, int length, float width, bool active) noexcept; // 对某个节点开启或关闭并更新
 		bool UpdatePositionByList(lua_State* L, int length, float width, int index, bool revert) noexcept; // 更改所有节点的坐标并更新
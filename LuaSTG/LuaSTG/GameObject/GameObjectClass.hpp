@@ -26,6 +26,7 @@ namespace LuaSTGPlus
 				uint32_t IsDefaultTrigger : 1;
 				uint32_t IsDefaultLegacyKill : 1;
 				uint32_t IsRenderClass : 1;
+				uint32_t CacheIndex : 24; // 在对象池类缓存中的序号，0 表示未缓存
 			};
 			uint32_t __Value{};
 		};
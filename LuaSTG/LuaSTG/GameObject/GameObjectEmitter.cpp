@@ -0,0 +1,67 @@
+﻿#include "GameObject/GameObjectEmitter.hpp"
+
+namespace LuaSTGPlus
+{
+	bool GameObjectEmitter::Step() noexcept
+	{
+		if (IsFinished())
+			return false;
+		bool const fire = timer >= delay && (timer - delay) % interval == 0;
+		timer += 1;
+		if (fire)
+			fired += 1;
+		return fire;
+	}
+
+	void GameObjectEmitter::MakeVolley(float base_angle, std::vector<Shot>& out)
+	{
+		out.clear();
+		out.reserve(count);
+		for (uint32_t i = 0; i < count; i += 1)
+		{
+			float a = base_angle;
+			if (count > 1)
+			{
+				if (spread >= 360.0f)
+					a += 360.0f * (float)i / (float)count;
+				else
+					a += spread * ((float)i / (float)(count - 1) - 0.5f);
+			}
+			float s = speed + speed_step * (float)i;
+			// 只在需要时消耗随机数，修改其他参数不会改变随机序列
+			if (random_angle > 0.0f)
+				a += random_angle * (2.0f * UtilRandom::to_float(random()) - 1.0f);
+			if (random_speed > 0.0f)
+				s += random_speed * (2.0f * UtilRandom::to_float(random()) - 1.0f);
+			out.push_back(Shot{ a, s });
+		}
+	}
+
+	void GameObjectEmitter::Save(GameObjectSnapshotWriter& w)
+	{
+		w.Write(id);
+		w.Write(has_owner); w.Write(owner_id); w.Write(owner_uid); w.Write(x); w.Write(y);
+		w.Write(has_target); w.Write(target_id); w.Write(target_uid);
+		w.WriteString(img); w.Write(group); w.Write(layer); w.Write(has_layer); w.Write(motion);
+		w.Write(count); w.Write(angle); w.Write(spread); w.Write(angle_step);
+		w.Write(speed); w.Write(speed_step); w.Write(accel);
+		w.Write(random_angle); w.Write(random_speed);
+		w.Write(delay); w.Write(interval); w.Write(shots);
+		w.Write(active); w.Write(dead); w.Write(timer); w.Write(fired);
+		w.WriteString(random.serialize());
+	}
+	bool GameObjectEmitter::Load(GameObjectSnapshotReader& r)
+	{
+		std::string random_state;
+		return r.Read(id)
+			&& r.Read(has_owner) && r.Read(owner_id) && r.Read(owner_uid) && r.Read(x) && r.Read(y)
+			&& r.Read(has_target) && r.Read(target_id) && r.Read(target_uid)
+			&& r.ReadString(img) && r.Read(group) && r.Read(layer) && r.Read(has_layer) && r.Read(motion)
+			&& r.Read(count) && r.Read(angle) && r.Read(spread) && r.Read(angle_step)
+			&& r.Read(speed) && r.Read(speed_step) && r.Read(accel)
+			&& r.Read(random_angle) && r.Read(random_speed)
+			&& r.Read(delay) && r.Read(interval) && r.Read(shots)
+			&& r.Read(active) && r.Read(dead) && r.Read(timer) && r.Read(fired)
+			&& r.ReadString(random_state) && random.deserialize(random_state);
+	}
+}
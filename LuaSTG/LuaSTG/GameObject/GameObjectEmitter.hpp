@@ -0,0 +1,80 @@
+﻿#pragma once
+#include "GameObject/GameObject.hpp"
+#include "GameObject/GameObjectSnapshot.hpp"
+#include "Utility/xorshift.hpp"
+
+namespace LuaSTGPlus
+{
+	// 弹幕发射器
+	// 按固定间隔发射一组子弹，子弹的方向和速度在 C++ 中计算，不经过 lua 回调；
+	// 随机偏移只使用发射器自己的随机数发生器，种子和发射顺序相同时结果相同，不会破坏录像
+	class GameObjectEmitter
+	{
+	public:
+		struct Shot
+		{
+			float angle; // 角度制
+			float speed;
+		};
+
+		uint64_t id{ 0 };
+
+		// 附着对象，发射位置为附着对象的坐标加上 x、y 偏移，附着对象回收后发射器也会被删除
+		bool has_owner{ false };
+		size_t owner_id{ 0 };
+		uint64_t owner_uid{ 0 };
+		float x{ 0.0f };
+		float y{ 0.0f };
+
+		// 瞄准对象，有效时基准方向加上从发射位置指向该对象的角度
+		bool has_target{ false };
+		size_t target_id{ 0 };
+		uint64_t target_uid{ 0 };
+
+		// 子弹，类保存在对象 table 的发射器表中；图像在创建发射器时查找，名称只用于快照
+		std::string img;
+		Core::ScopeObject<IResourceBase> res;
+		lua_Integer group{ 0 };
+		lua_Number layer{ 0.0 };
+		bool has_layer{ false };
+		uint32_t motion{ 0 }; // 运动程序，0 表示没有
+
+		// 发射参数
+		uint32_t count{ 1 };        // 每次发射的子弹数
+		float angle{ 0.0f };        // 基准方向
+		float spread{ 0.0f };       // 以基准方向为中心的扇形角度，大于等于 360 时为整圆均匀分布
+		float angle_step{ 0.0f };   // 每次发射后基准方向的增量
+		float speed{ 1.0f };        // 子弹速度
+		float speed_step{ 0.0f };   // 同一次发射中每颗子弹的速度增量
+		float accel{ 0.0f };        // 沿发射方向的加速度
+		float random_angle{ 0.0f }; // 方向的随机偏移范围 [-v, v]
+		float random_speed{ 0.0f }; // 速度的随机偏移范围 [-v, v]
+		int32_t delay{ 0 };         // 第一次发射前等待的帧数
+		int32_t interval{ 1 };      // 发射间隔（帧）
+		int32_t shots{ 0 };         // 发射次数，0 表示不限
+
+		// 状态
+		bool active{ true };
+		bool dead{ false };
+		int32_t timer{ 0 };
+		int32_t fired{ 0 };
+		UtilRandom::xoshiro128p random;
+
+		/// @brief 推进一帧，返回这一帧是否发射
+		bool Step() noexcept;
+
+		/// @brief 这一次发射的基准方向，包含 angle_step 的累加，不包含瞄准
+		float GetVolleyAngle() const noexcept { return angle + angle_step * (float)(fired - 1); }
+
+		/// @brief 计算一次发射中每颗子弹的方向和速度
+		/// @param base_angle 基准方向
+		void MakeVolley(float base_angle, std::vector<Shot>& out);
+
+		/// @brief 是否已经完成所有发射
+		bool IsFinished() const noexcept { return shots > 0 && fired >= shots; }
+
+		/// @brief 保存和恢复发射器状态，子弹类不在其中
+		void Save(GameObjectSnapshotWriter& w);
+		bool Load(GameObjectSnapshotReader& r);
+	};
+}
@@ -0,0 +1,160 @@
+﻿#include "GameObject/GameObjectMotion.hpp"
+
+namespace LuaSTGPlus
+{
+	void GameObjectMotion::TargetSet::Clear() noexcept
+	{
+		m_Targets.clear();
+		m_CellStart.clear();
+		m_CellItems.clear();
+		m_Width = 0;
+		m_Height = 0;
+		m_Built = false;
+	}
+
+	void GameObjectMotion::TargetSet::Add(GameObject const* p)
+	{
+		if (std::isfinite(p->x) && std::isfinite(p->y))
+			m_Targets.push_back(Target{ p, p->x, p->y, p->world });
+	}
+
+	void GameObjectMotion::TargetSet::Build()
+	{
+		m_Built = true;
+		m_Width = 0;
+		m_Height = 0;
+		size_t const n = m_Targets.size();
+		if (n <= LINEAR_LIMIT)
+			return;
+
+		// 正方形格子，平均每个格子约 2 个目标
+
+		float min_x = std::numeric_limits<float>::infinity();
+		float min_y = std::numeric_limits<float>::infinity();
+		float max_x = -std::numeric_limits<float>::infinity();
+		float max_y = -std::numeric_limits<float>::infinity();
+		for (auto const& t : m_Targets)
+		{
+			min_x = std::min(min_x, t.x);
+			min_y = std::min(min_y, t.y);
+			max_x = std::max(max_x, t.x);
+			max_y = std::max(max_y, t.y);
+		}
+		float const extent = std::max(max_x - min_x, max_y - min_y);
+		if (!std::isfinite(extent))
+			return;
+		float const cells = std::clamp(std::ceil(std::sqrt((float)n * 0.5f)), 1.0f, (float)MAX_GRID_SIZE);
+		m_OriginX = min_x;
+		m_OriginY = min_y;
+		m_CellSize = std::max(extent / cells, 1.0f);
+		m_Width = (int32_t)std::clamp(std::floor((max_x - min_x) / m_CellSize) + 1.0f, 1.0f, (float)MAX_GRID_SIZE);
+		m_Height = (int32_t)std::clamp(std::floor((max_y - min_y) / m_CellSize) + 1.0f, 1.0f, (float)MAX_GRID_SIZE);
+
+		// 计数排序，格子内保持加入顺序
+
+		size_t const cell_count = (size_t)m_Width * (size_t)m_Height;
+		m_CellStart.assign(cell_count + 1, 0);
+		for (auto const& t : m_Targets)
+			m_CellStart[(size_t)_CellY(t.y) * (size_t)m_Width + (size_t)_CellX(t.x) + 1] += 1;
+		for (size_t i = 0; i < cell_count; i += 1)
+			m_CellStart[i + 1] += m_CellStart[i];
+		m_CellItems.resize(n);
+		std::vector<uint32_t> cursor(m_CellStart.begin(), m_CellStart.end() - 1);
+		for (uint32_t i = 0; i < (uint32_t)n; i += 1)
+		{
+			Target const& t = m_Targets[i];
+			m_CellItems[cursor[(size_t)_CellY(t.y) * (size_t)m_Width + (size_t)_CellX(t.x)]++] = i;
+		}
+	}
+
+	void GameObjectMotion::AddSegment(Segment const& seg)
+	{
+		m_Segments.push_back(seg);
+		m_Length = std::max(m_Length, seg.start + std::max(seg.duration, 1));
+	}
+
+	size_t GameObjectMotion::GetHash() const noexcept
+	{
+		size_t h = m_Segments.size();
+		auto const combine = [&h](size_t v) { h ^= v + 0x9e3779b9 + (h << 6) + (h >> 2); };
+		for (auto const& seg : m_Segments)
+		{
+			combine((size_t)seg.op);
+			combine(std::hash<int32_t>{}(seg.start));
+			combine(std::hash<int32_t>{}(seg.duration));
+			combine(std::hash<float>{}(seg.value)); // 0.0 和 -0.0 相等，哈希值也相同
+			combine(std::hash<lua_Integer>{}(seg.group));
+		}
+		return h;
+	}
+
+	GameObjectMotion::Result GameObjectMotion::Step(GameObject* p, ITargetFinder& finder) const
+	{
+		int32_t const t = p->motion_timer;
+		p->motion_timer += 1;
+
+		// 速度和方向每次都从 vx、vy 取得，lua 或加速度对速度的修改仍然有效；速度为 0 时使用记录的方向
+		bool touched = false;
+		float speed = 0.0f;
+		float angle = 0.0f;
+		for (auto const& seg : m_Segments)
+		{
+			int32_t const duration = std::max(seg.duration, 1);
+			if (t < seg.start || t >= seg.start + duration)
+				continue;
+			if (seg.op == Op::Del)
+				return Result::Delete;
+			if (!touched)
+			{
+				touched = true;
+				speed = std::sqrt(p->vx * p->vx + p->vy * p->vy);
+				angle = speed > std::numeric_limits<float>::min() ? std::atan2(p->vy, p->vx) * (float)L_RAD_TO_DEG : p->motion_angle;
+			}
+			// 剩余帧数，每帧走完剩余差值的 1/remain，最后一帧正好到达目标值
+			float const remain = (float)(seg.start + duration - t);
+			switch (seg.op)
+			{
+			case Op::Speed:
+				speed += (seg.value - speed) / remain;
+				break;
+			case Op::Accel:
+				speed += seg.value;
+				break;
+			case Op::Angle:
+				angle += std::remainder(seg.value - angle, 360.0f) / remain;
+				break;
+			case Op::Turn:
+				angle += seg.value / (float)duration;
+				break;
+			case Op::Aim:
+			case Op::Home:
+				{
+					float tx = 0.0f, ty = 0.0f;
+					if (!finder.FindTarget(p, seg.group, tx, ty))
+						break;
+					float const aim = std::atan2(ty - p->y, tx - p->x) * (float)L_RAD_TO_DEG;
+					if (seg.op == Op::Aim)
+					{
+						angle += std::remainder(aim + seg.value - angle, 360.0f) / remain;
+					}
+					else
+					{
+						float const delta = std::remainder(aim - angle, 360.0f);
+						angle += seg.value > 0.0f ? std::clamp(delta, -seg.value, seg.value) : delta;
+					}
+				}
+				break;
+			default:
+				break;
+			}
+		}
+		if (touched)
+		{
+			speed = std::max(speed, 0.0f);
+			p->vx = speed * std::cos(angle * (float)L_DEG_TO_RAD);
+			p->vy = speed * std::sin(angle * (float)L_DEG_TO_RAD);
+			p->motion_angle = std::remainder(angle, 360.0f);
+		}
+		return p->motion_timer >= m_Length ? Result::Finished : Result::Running;
+	}
+}
@@ -0,0 +1,179 @@
+﻿#pragma once
+#include "GameObject/GameObject.hpp"
+
+namespace LuaSTGPlus
+{
+	// 运动程序
+	// 按对象运动程序计时器排列的一组片段，代替只在固定时间修改速度、方向的 frame 回调；
+	// 程序本身不保存对象状态，可以被任意多个对象共享
+	class GameObjectMotion
+	{
+	public:
+		enum class Op : uint8_t
+		{
+			Speed, // 在 time 帧内把速度线性过渡到 value
+			Accel, // 在 time 帧内每帧速度增加 value
+			Angle, // 在 time 帧内把方向线性过渡到 value（角度制，取较小的转向）
+			Turn,  // 在 time 帧内方向共转过 value（角度制）
+			Aim,   // 在 time 帧内把方向线性过渡到指向 group 中最近对象的方向加上 value
+			Home,  // 在 time 帧内每帧最多转过 value 朝向 group 中最近的对象，value 不大于 0 时直接指向
+			Del,   // 删除对象
+		};
+
+		struct Segment
+		{
+			Op op{ Op::Speed };
+			int32_t start{ 0 };    // 开始时间（帧）
+			int32_t duration{ 0 }; // 持续时间（帧），0 表示只在开始时执行一次
+			float value{ 0.0f };
+			lua_Integer group{ 0 }; // Aim、Home 的目标碰撞组
+			
+			bool operator==(Segment const&) const noexcept = default;
+		};
+
+		// 查找目标，由对象池实现
+		struct ITargetFinder
+		{
+			virtual bool FindTarget(GameObject const* self, lua_Integer group, float& x, float& y) = 0;
+		};
+
+		// 一组目标的坐标快照，目标较多时用均匀网格查找最近的目标；
+		// 只保存坐标，建立后对象被回收或移动都不影响查找，结果与按加入顺序逐个比较相同（距离相同时取先加入的目标）
+		class TargetSet
+		{
+		public:
+			struct Target
+			{
+				GameObject const* object; // 只用于排除查找者自身，不会访问
+				float x;
+				float y;
+				lua_Integer world;
+			};
+
+		private:
+			static constexpr size_t LINEAR_LIMIT = 32;   // 不超过此数量时直接遍历
+			static constexpr int32_t MAX_GRID_SIZE = 256; // 单轴最大格子数
+
+			std::vector<Target> m_Targets;
+			std::vector<uint32_t> m_CellStart; // 每个格子在 m_CellItems 中的起始位置，长度为格子数 + 1
+			std::vector<uint32_t> m_CellItems; // 格子内的目标序号，升序
+			float m_OriginX{ 0.0f };
+			float m_OriginY{ 0.0f };
+			float m_CellSize{ 1.0f };
+			int32_t m_Width{ 0 }; // 为 0 时直接遍历
+			int32_t m_Height{ 0 };
+			bool m_Built{ false };
+
+			inline int32_t _CellX(float x) const noexcept
+			{
+				return (int32_t)std::clamp(std::floor((x - m_OriginX) / m_CellSize), 0.0f, (float)(m_Width - 1));
+			}
+			inline int32_t _CellY(float y) const noexcept
+			{
+				return (int32_t)std::clamp(std::floor((y - m_OriginY) / m_CellSize), 0.0f, (float)(m_Height - 1));
+			}
+
+		public:
+			void Clear() noexcept;
+			bool IsBuilt() const noexcept { return m_Built; }
+
+			/// @brief 加入目标，坐标不是有限值的目标永远不会是最近的，直接忽略
+			void Add(GameObject const* p);
+
+			/// @brief 加入所有目标后建立网格
+			void Build();
+
+			/// @brief 查找离 (x, y) 最近并且 accept 返回 true 的目标，没有时返回 nullptr
+			template<typename F>
+			Target const* FindNearest(float x, float y, F&& accept) const
+			{
+				Target const* nearest = nullptr;
+				float nearest_d2 = std::numeric_limits<float>::infinity();
+				auto const visit = [&](Target const& t)
+				{
+					if (!accept(t))
+						return;
+					float const dx = t.x - x;
+					float const dy = t.y - y;
+					float const d2 = dx * dx + dy * dy;
+					if (d2 < nearest_d2 || (d2 == nearest_d2 && nearest && &t < nearest))
+					{
+						nearest = &t;
+						nearest_d2 = d2;
+					}
+				};
+				if (!std::isfinite(x) || !std::isfinite(y))
+					return nullptr;
+				if (m_Width == 0)
+				{
+					for (auto const& t : m_Targets)
+						visit(t);
+					return nearest;
+				}
+				// 由近到远逐圈查找，第 k 圈的目标距离至少为 (k - 1) 个格子，再留一个格子的余量抵消舍入误差
+				int32_t const cx = _CellX(x);
+				int32_t const cy = _CellY(y);
+				auto const visit_cell = [&](int32_t i, int32_t j)
+				{
+					if (i < 0 || i >= m_Width || j < 0 || j >= m_Height)
+						return;
+					size_t const cell = (size_t)j * (size_t)m_Width + (size_t)i;
+					for (uint32_t n = m_CellStart[cell]; n < m_CellStart[cell + 1]; n += 1)
+						visit(m_Targets[m_CellItems[n]]);
+				};
+				for (int32_t k = 0; ; k += 1)
+				{
+					if (nearest && k >= 2)
+					{
+						float const bound = (float)(k - 2) * m_CellSize;
+						if (bound * bound > nearest_d2)
+							break;
+					}
+					if (cx - k < 0 && cy - k < 0 && cx + k >= m_Width && cy + k >= m_Height)
+						break;
+					if (k == 0)
+					{
+						visit_cell(cx, cy);
+						continue;
+					}
+					for (int32_t i = std::max(cx - k, 0); i <= std::min(cx + k, m_Width - 1); i += 1)
+					{
+						visit_cell(i, cy - k);
+						visit_cell(i, cy + k);
+					}
+					for (int32_t j = std::max(cy - k + 1, 0); j <= std::min(cy + k - 1, m_Height - 1); j += 1)
+					{
+						visit_cell(cx - k, j);
+						visit_cell(cx + k, j);
+					}
+				}
+				return nearest;
+			}
+		};
+
+		enum class Result
+		{
+			Running,
+			Finished,
+			Delete,
+		};
+
+	private:
+		std::vector<Segment> m_Segments;
+		int32_t m_Length{ 0 };
+
+	public:
+		std::vector<Segment> const& GetSegments() const noexcept { return m_Segments; }
+		bool IsEmpty() const noexcept { return m_Segments.empty(); }
+
+		/// @brief 所有片段的哈希值，片段相同的程序哈希值相同
+		size_t GetHash() const noexcept;
+
+		/// @brief 添加片段
+		void AddSegment(Segment const& seg);
+
+		/// @brief 执行对象当前时间的所有片段，并推进对象的运动程序计时器
+		/// @note 只在有片段执行时读写 vx、vy，其余时间对象按普通的速度、加速度运动
+		Result Step(GameObject* p, ITargetFinder& finder) const;
+	};
+}
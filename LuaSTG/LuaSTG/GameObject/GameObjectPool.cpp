@@ -1,12 +1,19 @@
 ﻿#include "GameObject/GameObjectPool.h"
 #include "LuaBinding/LuaWrapper.hpp"
 #include "LuaBinding/lua_luastg_hash.hpp"
+#include "LuaBinding/lua_utility.hpp"
 #include "AppFrame.h"
 
 #include "SDL.h"
 
-#define LOBJPOOL_SIZE_INTERNAL (LOBJPOOL_SIZE + 1)
-#define LOBJPOOL_METATABLE_IDX (LOBJPOOL_SIZE_INTERNAL)
+// 对象 table 保存在 ot[id + 1]，对象池容量在运行时确定，内部数据放在非正数的位置，不受容量影响
+#define LOBJPOOL_METATABLE_IDX (0)
+#define LOBJPOOL_TABLECACHE_IDX (-1)
+#define LOBJPOOL_CLASSCACHE_IDX (-2)
+#define LOBJPOOL_EMITTER_IDX (-3) // 发射器表，[id] 为发射器的子弹类
+#define LOBJPOOL_CLASSINDEX_IDX (-4) // 类到类缓存序号的弱键表，类不再被引用时可以被回收
+#define LOBJPOOL_OBJECT_UID_IDX 5 // 对象 table 的 [5] 为创建时对象的 uid，回收复用的 table 会被重新标记，用于识别旧的引用
+#define LOBJPOOL_CLASSCACHE_STRIDE 8 // 类缓存中每个类占用的槽位，[i * 8] 为类，[i * 8 + cbidx] 为回调函数
 
 namespace LuaSTGPlus
 {
@@ -14,7 +21,8 @@ namespace LuaSTGPlus
 
     static GameObjectPool* g_GameObjectPool = nullptr;
 
-    GameObjectPool::GameObjectPool(lua_State* pL)
+    GameObjectPool::GameObjectPool(lua_State* pL, size_t capacity)
+        : m_ObjectPool(std::clamp<size_t>(capacity, 1, LOBJPOOL_SIZE_MAX))
     {
         assert(g_GameObjectPool == nullptr);
         g_GameObjectPool = this;
@@ -22,16 +30,19 @@ namespace LuaSTGPlus
         G_L = pL;
         // 初始化对象链表
         _ClearLinkList();
-        m_RenderList.clear();
+        m_RenderList.Clear();
         // ex+
         m_pCurrentObject = nullptr;
         m_superpause = 0;
         m_nextsuperpause = 0;
+        m_TableCacheMax = m_ObjectPool.max_size();
         // lua
         _PrepareLuaObjectTable();
     }
     GameObjectPool::~GameObjectPool()
     {
+        // 析构时不再回收对象 table，缓存只清空已有的元素，不会分配内存，也就不会抛出 lua 错误
+        m_TableRecycling = false;
         ResetPool();
         g_GameObjectPool = nullptr;
     }
@@ -107,17 +118,17 @@ namespace LuaSTGPlus
 
     void GameObjectPool::_InsertToRenderList(GameObject* p)
     {
-        m_RenderList.insert(p);
+        m_RenderList.Insert(p);
     }
     void GameObjectPool::_RemoveFromRenderList(GameObject* p)
     {
-        m_RenderList.erase(p);
+        m_RenderList.Remove(p);
     }
     void GameObjectPool::_SetObjectLayer(GameObject* object, lua_Number layer)
     {
-        m_RenderList.erase(object);
+        m_RenderList.Remove(object);
         object->layer = layer;
-        m_RenderList.insert(object);
+        m_RenderList.Insert(object);
     }
 
     void GameObjectPool::_PrepareLuaObjectTable()
@@ -130,13 +141,27 @@ namespace LuaSTGPlus
 
         // 创建一个全局表用于存放所有对象
         lua_pushlightuserdata(G_L, this);					// ??? p
-        lua_createtable(G_L, LOBJPOOL_SIZE_INTERNAL, 0);	// ??? p ot
+        lua_createtable(G_L, (int)std::min<size_t>(m_ObjectPool.max_size(), LOBJPOOL_SIZE), 3);	// ??? p ot
 
         // 创建对象元表
         lua_createtable(G_L, 0, 2);							// ??? p ot mt
         luaL_register(G_L, NULL, mt);						// ??? p ot mt
         lua_rawseti(G_L, -2, LOBJPOOL_METATABLE_IDX);		// ??? p ot
 
+        // 创建回收的对象 table 缓存
+        lua_createtable(G_L, 0, 0);							// ??? p ot cache
+        lua_rawseti(G_L, -2, LOBJPOOL_TABLECACHE_IDX);		// ??? p ot
+
+        // 创建类缓存
+        lua_createtable(G_L, 0, 0);							// ??? p ot cc
+        lua_rawseti(G_L, -2, LOBJPOOL_CLASSCACHE_IDX);		// ??? p ot
+        _NewClassIndexTable(G_L);							// ??? p ot ci
+        lua_rawseti(G_L, -2, LOBJPOOL_CLASSINDEX_IDX);		// ??? p ot
+
+        // 创建发射器表
+        lua_createtable(G_L, 0, 0);							// ??? p ot et
+        lua_rawseti(G_L, -2, LOBJPOOL_EMITTER_IDX);			// ??? p ot
+
         // 保存对象表
         lua_settable(G_L, LUA_REGISTRYINDEX);				// ???
     }
@@ -163,6 +188,7 @@ namespace LuaSTGPlus
         _InsertToUpdateLinkList(p);
         _InsertToRenderList(p);
         _InsertToColliLinkList(p, (size_t)p->group);
+        _MarkColliGroupDirty(p->group);
         m_DbgData[m_DbgIdx].object_alloc += 1;
         return p;
     }
@@ -173,6 +199,7 @@ namespace LuaSTGPlus
         _RemoveFromUpdateLinkList(object);
         _RemoveFromRenderList(object);
         _RemoveFromColliLinkList(object);
+        _MarkColliGroupDirty(object->group);
         if (m_pCurrentObject == object)
         {
             m_pCurrentObject = nullptr;
@@ -181,7 +208,7 @@ namespace LuaSTGPlus
         m_ObjectPool.free(object->id);
         return ret;
     }
-    GameObject* GameObjectPool::_FreeObject(GameObject* p, int ot_at) noexcept
+    GameObject* GameObjectPool::_FreeObject(GameObject* p, int ot_at)
     {
         int const index = (int)p->id + 1;
         int ot_stk = ot_at;
@@ -199,9 +226,16 @@ namespace LuaSTGPlus
         }
         lua_rawgeti(G_L, ot_stk, index);		// ot object
         p->ReleaseLuaRC(G_L, lua_gettop(G_L));	// ot object				// 释放可能的粒子系统
-        lua_pushlightuserdata(G_L, nullptr);	// ot object nullptr
-        lua_rawseti(G_L, -2, 3);				// ot object
-        lua_pop(G_L, 1);						// ot
+        if (m_TableRecycling && m_TableCacheCount < m_TableCacheMax)
+        {
+            _RecycleObjectTable(G_L, ot_stk);	// ot
+        }
+        else
+        {
+            lua_pushlightuserdata(G_L, nullptr);	// ot object nullptr
+            lua_rawseti(G_L, -2, 3);				// ot object
+            lua_pop(G_L, 1);						// ot
+        }
         lua_pushnil(G_L);						// ot nil
         lua_rawseti(G_L, ot_stk, index);		// ot
         if (ot_at <= 0)
@@ -217,6 +251,148 @@ namespace LuaSTGPlus
         return pRet;
     }
 
+    void GameObjectPool::_RecycleObjectTable(lua_State* L, int ot_idx)
+    {
+        //											// ... object
+        // 清空所有字段，包括 class、id、GameObject 指针和 uid，旧的引用会被视为无效对象；
+        // table 复用后旧的引用和新对象是同一个 table，只能通过比较之前保存的 uid 识别
+        int const obj_idx = lua_gettop(L);
+        lua_pushnil(L);								// ... object nil
+        while (lua_next(L, obj_idx))				// ... object k v
+        {
+            lua_pop(L, 1);							// ... object k
+            lua_pushvalue(L, -1);					// ... object k k
+            lua_pushnil(L);							// ... object k k nil
+            lua_rawset(L, obj_idx);					// ... object k
+        }
+        lua_rawgeti(L, ot_idx, LOBJPOOL_TABLECACHE_IDX);	// ... object cache
+        lua_insert(L, -2);									// ... cache object
+        m_TableCacheCount += 1;
+        lua_rawseti(L, -2, (int)m_TableCacheCount);			// ... cache
+        lua_pop(L, 1);										// ...
+    }
+    void GameObjectPool::_NewObjectTable(lua_State* L, int ot_idx)
+    {
+        if (m_TableCacheCount > 0)
+        {
+            lua_rawgeti(L, ot_idx, LOBJPOOL_TABLECACHE_IDX);	// ... cache
+            lua_rawgeti(L, -1, (int)m_TableCacheCount);			// ... cache object
+            lua_pushnil(L);										// ... cache object nil
+            lua_rawseti(L, -3, (int)m_TableCacheCount);			// ... cache object
+            lua_remove(L, -2);									// ... object
+            m_TableCacheCount -= 1;
+            m_TableCacheHits += 1;
+            m_DbgData[m_DbgIdx].object_table_reuse += 1;
+        }
+        else
+        {
+            lua_createtable(L, LOBJPOOL_OBJECT_UID_IDX, 0);	// ... object
+            if (m_TableRecycling)
+                m_TableCacheMisses += 1;
+        }
+    }
+    void GameObjectPool::_ClearObjectTableCache(lua_State* L)
+    {
+        // 从后往前置空，只修改数组部分已有的元素，不会分配内存
+        GetObjectTable(L);								// ot
+        lua_rawgeti(L, -1, LOBJPOOL_TABLECACHE_IDX);	// ot cache
+        for (; m_TableCacheCount > 0; m_TableCacheCount -= 1)
+        {
+            lua_pushnil(L);								// ot cache nil
+            lua_rawseti(L, -2, (int)m_TableCacheCount);	// ot cache
+        }
+        lua_pop(L, 2);
+    }
+    void GameObjectPool::SetObjectTableRecycling(bool enable, size_t max_count)
+    {
+        m_TableRecycling = enable;
+        m_TableCacheMax = std::min<size_t>(max_count, m_ObjectPool.max_size());
+        if (!enable || m_TableCacheCount > m_TableCacheMax)
+        {
+            _ClearObjectTableCache(G_L);
+        }
+    }
+    int GameObjectPool::GetObjectTableRecyclingInfo(lua_State* L) noexcept
+    {
+        lua_pushinteger(L, (lua_Integer)m_TableCacheCount);
+        lua_pushinteger(L, (lua_Integer)m_TableCacheHits);
+        lua_pushinteger(L, (lua_Integer)m_TableCacheMisses);
+        lua_pushinteger(L, (lua_Integer)(m_TableCacheHits * OBJECT_TABLE_ESTIMATED_SIZE)); // 估计值
+        return 4;
+    }
+
+    void GameObjectPool::_BeginSetMember(_MemberChange& c, GameObject* p) noexcept
+    {
+        c.object = p;
+        c.group = p->group;
+        c.next_group = p->group;
+        c.x = p->x;
+        c.y = p->y;
+        c.col_r = p->col_r;
+        c.swept = p->swept;
+        c.moved = false;
+        c.layer_changed = false;
+    }
+    void GameObjectPool::_SetMember(lua_State* L, _MemberChange& c, LuaSTG::GameObjectMember member, int ki, int vi)
+    {
+        GameObject* p = c.object;
+        int const result = p->SetMember(L, member, ki, vi);
+        if (!c.moved && (p->x != c.x || p->y != c.y || p->col_r != c.col_r || p->swept != c.swept))
+        {
+            _MarkColliGroupDirty(p->group);
+            c.moved = true;
+        }
+        switch (member)
+        {
+        case LuaSTG::GameObjectMember::GROUP:
+            // 先恢复碰撞组，链表移动之前对象必须在原来的碰撞组中
+            c.next_group = p->group;
+            p->group = c.group;
+            break;
+        case LuaSTG::GameObjectMember::LAYER:
+            c.layer_changed = (result == 2);
+            break;
+        case LuaSTG::GameObjectMember::CLASS:
+        #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+            if (result == 3)
+            {
+                lua_rawgeti(L, 1, 1);					// ??? class
+                GetObjectTable(L);						// ??? class ot
+                _ResolveClass(L, -2, lua_gettop(L), p->luaclass);
+                lua_pop(L, 2);							// ???
+            }
+        #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+            break;
+        default:
+            break;
+        }
+    }
+    void GameObjectPool::_EndSetMember(lua_State* L, _MemberChange& c)
+    {
+        GameObject* p = c.object;
+        if (c.next_group != c.group)
+        {
+            if (p == m_LockObjectA || p == m_LockObjectB)
+            {
+                luaL_error(L, "illegal operation, lstg object 'group' property should not be modified in 'lstg.CollisionCheck'");
+                return;
+            }
+            p->group = c.next_group;
+            _MoveToColliLinkList(p, (size_t)p->group);
+            _MarkColliGroupDirty(c.group);
+            _MarkColliGroupDirty(p->group);
+        }
+        if (c.layer_changed)
+        {
+            if (m_IsRendering)
+            {
+                luaL_error(L, "illegal operation, lstg object 'layer' property should not be modified in 'lstg.ObjRender'");
+                return;
+            }
+            _SetObjectLayer(p, p->nextlayer);
+        }
+    }
+
     GameObject* GameObjectPool::_ToGameObject(lua_State* L, int idx)
     {
         if (!lua_istable(L, idx))
@@ -242,8 +418,20 @@ namespace LuaSTGPlus
         return p;
     }
 
-    void GameObjectPool::_GameObjectCallback(lua_State* L, int otidx, GameObject* p, int cbidx)
+    void GameObjectPool::_GameObjectCallback(lua_State* L, int otidx, int ccidx, GameObject* p, int cbidx)
     {
+    #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+        if (p->luaclass.CacheIndex != 0)
+        {
+            // 直接从类缓存中取回调函数
+            lua_rawgeti(L, ccidx, (int)p->luaclass.CacheIndex * LOBJPOOL_CLASSCACHE_STRIDE + cbidx);	// ??? ot cc frame
+            lua_rawgeti(L, otidx, (int)p->id + 1);	// ??? ot cc frame object
+            lua_call(L, 1, 0);						// ??? ot cc
+            return;
+        }
+    #else // USING_ADVANCE_GAMEOBJECT_CLASS
+        std::ignore = ccidx;
+    #endif // USING_ADVANCE_GAMEOBJECT_CLASS
         lua_rawgeti(L, otidx, (int)p->id + 1);	// ??? ot object
         lua_rawgeti(L, -1, 1);					// ??? ot object class
         lua_rawgeti(L, -1, cbidx);				// ??? ot object class frame
@@ -251,6 +439,140 @@ namespace LuaSTGPlus
         lua_call(L, 1, 0);						// ??? ot object class
         lua_pop(L, 2);							// ??? ot
     }
+    void GameObjectPool::_ResolveClass(lua_State* L, int class_idx, int ot_idx, GameObjectClass& out)
+    {
+    #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+        if (class_idx < 0)
+            class_idx = lua_gettop(L) + class_idx + 1;
+        lua_rawgeti(L, ot_idx, LOBJPOOL_CLASSCACHE_IDX);	// ??? cc
+        int const cc_idx = lua_gettop(L);
+        lua_rawgeti(L, ot_idx, LOBJPOOL_CLASSINDEX_IDX);	// ??? cc ci
+        int const ci_idx = lua_gettop(L);
+        lua_pushvalue(L, class_idx);						// ??? cc ci class
+        lua_rawget(L, ci_idx);								// ??? cc ci index
+        size_t index = (size_t)lua_tointeger(L, -1);
+        lua_pop(L, 1);										// ??? cc ci
+        if (index == 0)
+        {
+            // 序号保存在 CacheIndex 的 24 位中，ResetPool 时清空，正常情况下不会用完
+            if (m_ClassCache.size() >= MAX_CLASS_CACHE)
+                luaL_error(L, "too many luastg object classes, class cache is full.");
+            m_ClassCache.emplace_back();
+            index = m_ClassCache.size();
+            lua_pushvalue(L, class_idx);					// ??? cc ci class
+            lua_pushinteger(L, (lua_Integer)index);			// ??? cc ci class index
+            lua_rawset(L, ci_idx);							// ??? cc ci
+            lua_pushvalue(L, class_idx);					// ??? cc ci class
+            lua_rawseti(L, cc_idx, (int)index * LOBJPOOL_CLASSCACHE_STRIDE);	// ??? cc ci
+            _RefreshClassCache(L, cc_idx, index);
+        }
+        out = m_ClassCache[index - 1];
+        lua_pop(L, 2);										// ???
+    #else // USING_ADVANCE_GAMEOBJECT_CLASS
+        std::ignore = L;
+        std::ignore = class_idx;
+        std::ignore = ot_idx;
+        std::ignore = out;
+    #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+    }
+    void GameObjectPool::_RefreshClassCache(lua_State* L, int cc_idx, size_t index)
+    {
+    #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+        int const base = (int)index * LOBJPOOL_CLASSCACHE_STRIDE;
+        lua_rawgeti(L, cc_idx, base);				// ??? class
+        GameObjectClass& cls = m_ClassCache[index - 1];
+        cls.CheckClassClass(L, lua_gettop(L));
+        cls.CacheIndex = (uint32_t)index;
+        for (int cbidx = LGOBJ_CC_INIT; cbidx <= LGOBJ_CC_KILL; cbidx += 1)
+        {
+            lua_rawgeti(L, -1, cbidx);				// ??? class f
+            lua_rawseti(L, cc_idx, base + cbidx);	// ??? class
+        }
+        lua_pop(L, 1);								// ???
+    #else // USING_ADVANCE_GAMEOBJECT_CLASS
+        std::ignore = L;
+        std::ignore = cc_idx;
+        std::ignore = index;
+    #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+    }
+    void GameObjectPool::_NewClassIndexTable(lua_State* L)
+    {
+        lua_createtable(L, 0, 0);					// ci
+        lua_createtable(L, 0, 1);					// ci mt
+        lua_pushstring(L, "k");						// ci mt "k"
+        lua_setfield(L, -2, "__mode");				// ci mt
+        lua_setmetatable(L, -2);					// ci
+    }
+    void GameObjectPool::_ClearClassCache(lua_State* L, int ot_idx)
+    {
+        // 调用者可能正把这两个表放在栈上使用，原地置空；只置空已有的元素，不会分配内存
+        lua_rawgeti(L, ot_idx, LOBJPOOL_CLASSCACHE_IDX);	// ??? cc
+        int const last = (int)(m_ClassCache.size() + 1) * LOBJPOOL_CLASSCACHE_STRIDE;
+        for (int i = LOBJPOOL_CLASSCACHE_STRIDE; i < last; i += 1)
+        {
+            lua_rawgeti(L, -1, i);							// ??? cc v
+            bool const has_value = !lua_isnil(L, -1);
+            lua_pop(L, 1);									// ??? cc
+            if (has_value)
+            {
+                lua_pushnil(L);								// ??? cc nil
+                lua_rawseti(L, -2, i);						// ??? cc
+            }
+        }
+        lua_pop(L, 1);										// ???
+        lua_rawgeti(L, ot_idx, LOBJPOOL_CLASSINDEX_IDX);	// ??? ci
+        lua_pushnil(L);										// ??? ci nil
+        while (lua_next(L, -2))								// ??? ci class index
+        {
+            lua_pop(L, 1);									// ??? ci class
+            lua_pushvalue(L, -1);							// ??? ci class class
+            lua_pushnil(L);									// ??? ci class class nil
+            lua_rawset(L, -4);								// ??? ci class
+        }
+        lua_pop(L, 1);										// ???
+        m_ClassCache.clear();
+        m_ClassCacheGeneration += 1;
+    }
+    int GameObjectPool::RefreshClass(lua_State* L)
+    {
+    #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+        GetObjectTable(L);									// ??? ot
+        int const ot_idx = lua_gettop(L);
+        lua_rawgeti(L, ot_idx, LOBJPOOL_CLASSCACHE_IDX);	// ??? ot cc
+        int const cc_idx = lua_gettop(L);
+        size_t first = 1;
+        size_t last = m_ClassCache.size();
+        if (!lua_isnoneornil(L, 1))
+        {
+            if (!GameObjectClass::CheckClassValid(L, 1))
+                return luaL_error(L, "invalid argument #1, luastg object class required for 'RefreshClass'.");
+            lua_rawgeti(L, ot_idx, LOBJPOOL_CLASSINDEX_IDX);	// ??? ot cc ci
+            lua_pushvalue(L, 1);							// ??? ot cc ci class
+            lua_rawget(L, -2);								// ??? ot cc ci index
+            first = (size_t)lua_tointeger(L, -1);
+            last = first;
+            lua_pop(L, 2);									// ??? ot cc
+        }
+        if (first != 0)
+        {
+            for (size_t index = first; index <= last; index += 1)
+            {
+                _RefreshClassCache(L, cc_idx, index);
+            }
+            // 同步已有对象的类特性
+            for (GameObject* p = m_UpdateLinkList.first.pUpdateNext; p != &m_UpdateLinkList.second; p = p->pUpdateNext)
+            {
+                size_t const index = p->luaclass.CacheIndex;
+                if (first <= index && index <= last)
+                    p->luaclass = m_ClassCache[index - 1];
+            }
+        }
+        lua_pop(L, 2);										// ???
+    #else // USING_ADVANCE_GAMEOBJECT_CLASS
+        std::ignore = L;
+    #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+        return 0;
+    }
 
     // --------------------------------------------------------------------------------
 
@@ -262,6 +584,12 @@ namespace LuaSTGPlus
         m_DbgData[m_DbgIdx].object_alive = m_ObjectPool.size();
         m_DbgData[m_DbgIdx].object_colli_check = 0;
         m_DbgData[m_DbgIdx].object_colli_callback = 0;
+        m_DbgData[m_DbgIdx].object_table_reuse = 0;
+        m_DbgData[m_DbgIdx].object_render_culled = 0;
+        m_DbgData[m_DbgIdx].object_render_batched = 0;
+        m_DbgData[m_DbgIdx].step_time = {};
+        m_DbgData[m_DbgIdx].colli_pair_count = 0;
+        m_DbgData[m_DbgIdx].colli_pair = {};
     }
     GameObjectPool::FrameStatistics GameObjectPool::DebugGetFrameStatistics()
     {
@@ -269,6 +597,10 @@ namespace LuaSTGPlus
         size_t const i = (m_DbgIdx + n - 1) % n;
         return m_DbgData[i];
     }
+    GameObjectPool::FrameStatistics GameObjectPool::DebugGetCurrentFrameStatistics()
+    {
+        return m_DbgData[m_DbgIdx];
+    }
 
     int GameObjectPool::GetObjectTable(lua_State* L) noexcept
     {
@@ -292,7 +624,7 @@ namespace LuaSTGPlus
         return _ToGameObject(L, idx);
     }
 
-    void GameObjectPool::ResetPool() noexcept
+    void GameObjectPool::ResetPool()
     {
         // 回收已分配的对象和更新链表
         GetObjectTable(G_L);
@@ -301,8 +633,9 @@ namespace LuaSTGPlus
         {
             p = _FreeObject(p, ot_at);
         }
+        _ClearObjectTableCache(G_L);
     #if (defined(_DEBUG) && defined(LuaSTG_enable_GameObjectManager_Debug))
-        for (int i = 1; i <= LOBJPOOL_SIZE; i += 1)
+        for (int i = 1; i <= (int)m_ObjectPool.reserved_size(); i += 1)
         {
             // 确保所有 lua 侧对象都被正确回收
             lua_rawgeti(G_L, ot_at, i);
@@ -310,10 +643,21 @@ namespace LuaSTGPlus
             lua_pop(G_L, 1);
         }
     #endif
+        // 删除所有发射器，序号重新从 1 开始，保证录像中默认的随机数种子一致
+        m_Emitters.clear();
+        m_EmitterId = 0;
+        m_EmitterGeneration += 1;
+        lua_createtable(G_L, 0, 0);
+        lua_rawseti(G_L, ot_at, LOBJPOOL_EMITTER_IDX);
+        // 所有对象都已回收，清空类缓存，不再引用之前用过的类
+        _ClearClassCache(G_L, ot_at);
         lua_pop(G_L, 1);
         // 重置其他链表
         _ClearLinkList();
-        m_RenderList.clear();
+        m_RenderList.Clear();
+        // 没有对象和发射器了，回收 lua 不再引用的运动程序
+        if (m_MotionCollect)
+            _CollectMotions();
         // 重置整个对象池，恢复为线性状态
         m_ObjectPool.clear();
         // 重置其他数据
@@ -322,49 +666,259 @@ namespace LuaSTGPlus
         m_pCurrentObject = nullptr;
         m_superpause = 0;
         m_nextsuperpause = 0;
+        _MarkAllColliGroupDirty();
+        for (auto& grid : m_ColliGrid)
+            grid.Clear();
+        for (auto& grid : m_QueryGrid)
+            grid.Clear();
+        for (auto& targets : m_MotionTargets)
+            targets.Clear();
+    }
+    int GameObjectPool::CompactPool(lua_State* L)
+    {
+        if (m_pCurrentObject || m_IsRendering || m_LockObjectA || m_LockObjectB || m_IterationDepth > 0)
+        {
+            return luaL_error(L, "illegal operation, object pool can not be compacted in object callbacks, 'lstg.ObjFrame', 'lstg.ObjRender', 'lstg.BoundCheck', 'lstg.CollisionCheck' or 'lstg.ForEachInGroup'.");
+        }
+        // 迭代器保存了对象的地址，整理后会跳到其他对象上，让没有遍历结束的迭代器停止
+        m_ObjectIdGeneration += 1;
+
+        // 按更新顺序记录对象，以及每个碰撞组内的顺序
+
+        size_t const n = m_ObjectPool.size();
+        std::vector<GameObject> objects;
+        std::vector<size_t> old_id;
+        std::vector<size_t> new_id(m_ObjectPool.reserved_size(), 0);
+        std::array<std::vector<size_t>, LOBJPOOL_GROUPN> colli_order;
+        objects.reserve(n);
+        old_id.reserve(n);
+        size_t moved = 0;
+        for (GameObject* p = m_UpdateLinkList.first.pUpdateNext; p != &m_UpdateLinkList.second; p = p->pUpdateNext)
+        {
+            new_id[p->id] = objects.size();
+            if (p->id != objects.size())
+                moved += 1;
+            old_id.push_back(p->id);
+            objects.push_back(*p);
+        }
+        if (moved == 0)
+        {
+            lua_pushinteger(L, 0);
+            return 1;
+        }
+        for (size_t group = 0; group < LOBJPOOL_GROUPN; group += 1)
+        {
+            auto& order = colli_order[group];
+            for (GameObject* p = m_ColliLinkList[group].first.pColliNext; p != &m_ColliLinkList[group].second; p = p->pColliNext)
+                order.push_back(new_id[p->id]);
+        }
+
+        // 重新分配，分配策略保证清空后按 0, 1, 2 ... 的顺序分配
+
+        _ClearLinkList();
+        m_RenderList.Clear();
+        // 和 _FreeObject 一样把原来的槽位标记为空闲，腾出来的槽位上留下的旧数据不能再通过 lstg.IsObjViewValid 检查
+        for (size_t const id : old_id)
+            m_ObjectPool.object(id)->status = GameObjectStatus::Free;
+        m_ObjectPool.clear();
+        for (size_t i = 0; i < objects.size(); i += 1)
+        {
+            size_t id = 0;
+            m_ObjectPool.alloc(id);
+            assert(id == i);
+            GameObject* p = m_ObjectPool.object(id);
+            *p = objects[i];
+            p->id = id;
+            _InsertToUpdateLinkList(p);
+            _InsertToRenderList(p);
+        }
+        for (size_t group = 0; group < LOBJPOOL_GROUPN; group += 1)
+        {
+            for (size_t const id : colli_order[group])
+                _InsertToColliLinkList(m_ObjectPool.object(id), group);
+        }
+        m_RenderList.Flush();
+        _MarkAllColliGroupDirty();
+        for (auto& e : m_Emitters)
+        {
+            // 失效的对象不会再匹配 uid，序号不需要更新
+            if (e.has_owner && e.owner_id < new_id.size())
+                e.owner_id = new_id[e.owner_id];
+            if (e.has_target && e.target_id < new_id.size())
+                e.target_id = new_id[e.target_id];
+        }
+
+        // 移动对象 table，先全部取出再放回，避免覆盖还没移动的对象
+
+        GetObjectTable(L);											// ??? ot
+        int const ot_idx = lua_gettop(L);
+        lua_createtable(L, (int)objects.size(), 0);					// ??? ot tmp
+        int const tmp_idx = lua_gettop(L);
+        for (size_t i = 0; i < objects.size(); i += 1)
+        {
+            lua_rawgeti(L, ot_idx, (int)old_id[i] + 1);				// ??? ot tmp object
+            lua_rawseti(L, tmp_idx, (int)i + 1);					// ??? ot tmp
+            lua_pushnil(L);											// ??? ot tmp nil
+            lua_rawseti(L, ot_idx, (int)old_id[i] + 1);				// ??? ot tmp
+        }
+        for (size_t i = 0; i < objects.size(); i += 1)
+        {
+            lua_rawgeti(L, tmp_idx, (int)i + 1);					// ??? ot tmp object
+            lua_pushinteger(L, (lua_Integer)i);						// ??? ot tmp object id
+            lua_rawseti(L, -2, 2);									// ??? ot tmp object
+            lua_pushlightuserdata(L, m_ObjectPool.object(i));		// ??? ot tmp object pGameObject
+            lua_rawseti(L, -2, 3);									// ??? ot tmp object
+            lua_rawseti(L, ot_idx, (int)i + 1);						// ??? ot tmp
+        }
+        lua_pop(L, 2);												// ???
+
+        lua_pushinteger(L, (lua_Integer)moved);
+        return 1;
     }
     void GameObjectPool::DoFrame()
     {
         ZoneScopedN("LOBJMGR.ObjFrame");
 
-        //处理超级暂停
         GetObjectTable(G_L);  // ot
         int const ot_idx = lua_gettop(G_L);
+        lua_rawgeti(G_L, ot_idx, LOBJPOOL_CLASSCACHE_IDX); // ot cc
+        int const cc_idx = lua_gettop(G_L);
 
+        _DoFrame(ot_idx, cc_idx);
+
+        lua_pop(G_L, 2);
+    }
+    void GameObjectPool::_DoFrame(int ot_idx, int cc_idx)
+    {
+        _IterationScope const scope(*this);
+        _QueryGridFreezeScope const freeze(*this);
+        //处理超级暂停
         m_pCurrentObject = nullptr;
+        for (auto& targets : m_MotionTargets)
+            targets.Clear();
         int superpause = UpdateSuperPause();
+        _UpdateEmitters(ot_idx, superpause);
         for (GameObject* p = m_UpdateLinkList.first.pUpdateNext; p != &m_UpdateLinkList.second; p = p->pUpdateNext)
         {
             // 根据id获取对象的lua绑定table、拿到class再拿到framefunc
             if (superpause <= 0 || p->ignore_superpause)
             {
                 m_pCurrentObject = p;
+                if (p->motion != 0)
+                {
+                    float const x = p->x;
+                    float const y = p->y;
+                    if (!_UpdateMotion(p, ot_idx, cc_idx))
+                    {
+                        continue; // 运动程序删除了对象
+                    }
+                    _MarkColliGroupDirtyIfMoved(p, x, y);
+                }
             #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
                 if (!p->luaclass.IsDefaultUpdate)
                 {
             #endif // USING_ADVANCE_GAMEOBJECT_CLASS
-                    _GameObjectCallback(G_L, ot_idx, p, LGOBJ_CC_FRAME);
+                    _GameObjectCallback(G_L, ot_idx, cc_idx, p, LGOBJ_CC_FRAME);
             #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
                 }
             #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+                // 积分直接修改坐标，只有真正移动的对象才使所在碰撞组的网格失效
+                float const x = p->x;
+                float const y = p->y;
                 p->Update();
+                _MarkColliGroupDirtyIfMoved(p, x, y);
             }
         }
         m_pCurrentObject = nullptr;
-
-        lua_pop(G_L, 1);
+    }
+    // 对象图像的外接圆半径，没有图像或者是粒子时返回负数，表示无法剔除
+    static float _GetRenderRadius(GameObject const* p) noexcept
+    {
+        if (!p->res)
+            return -1.0f;
+        IResourceSprite* sprite = nullptr;
+        switch (p->res->GetType())
+        {
+        case ResourceType::Sprite:
+            sprite = static_cast<IResourceSprite*>(p->res);
+            break;
+        case ResourceType::Animation:
+            sprite = static_cast<IResourceAnimation*>(p->res)->GetSprite(0);
+            break;
+        default:
+            return -1.0f;
+        }
+        if (!sprite)
+            return -1.0f;
+        auto* s = sprite->GetSprite();
+        Core::RectF const rc = s->getTextureRect();
+        // 中心点可以在图像内任意位置，用对角线长度作为半径
+        float const size = std::hypot(rc.width(), rc.height()) * s->getUnitsPerPixel();
+        float const scale = std::max(std::abs(p->hscale), std::abs(p->vscale)) * LRES.GetGlobalImageScaleFactor();
+        return std::max(size * scale, p->col_r);
+    }
+    bool GameObjectPool::_IsRenderCulled(GameObject const* p) const noexcept
+    {
+        if (p->no_cull)
+            return false;
+        CullRect rc{};
+        if (m_RenderCullUseRect)
+        {
+            rc = m_RenderCullRect;
+        }
+        else if (m_RenderCullHasOrtho)
+        {
+            rc.left = m_RenderCullOrtho.left - m_RenderCullMargin;
+            rc.right = m_RenderCullOrtho.right + m_RenderCullMargin;
+            rc.bottom = m_RenderCullOrtho.bottom - m_RenderCullMargin;
+            rc.top = m_RenderCullOrtho.top + m_RenderCullMargin;
+        }
+        else
+        {
+            return false;
+        }
+        float const r = _GetRenderRadius(p);
+        if (r < 0.0f)
+            return false;
+        return p->x + r < rc.left || p->x - r > rc.right || p->y + r < rc.bottom || p->y - r > rc.top;
+    }
+    void GameObjectPool::SetRenderCulling(bool enable, float margin) noexcept
+    {
+        m_RenderCull = enable;
+        m_RenderCullMargin = std::max(margin, 0.0f);
+    }
+    void GameObjectPool::SetRenderCullRect(float left, float right, float bottom, float top) noexcept
+    {
+        m_RenderCullUseRect = true;
+        m_RenderCullRect = CullRect{ std::min(left, right), std::max(left, right), std::min(bottom, top), std::max(bottom, top) };
+    }
+    void GameObjectPool::ResetRenderCullRect() noexcept
+    {
+        m_RenderCullUseRect = false;
+    }
+    void GameObjectPool::SetRenderCullOrtho(float left, float right, float bottom, float top) noexcept
+    {
+        m_RenderCullHasOrtho = true;
+        m_RenderCullOrtho = CullRect{ std::min(left, right), std::max(left, right), std::min(bottom, top), std::max(bottom, top) };
+    }
+    void GameObjectPool::ResetRenderCullOrtho() noexcept
+    {
+        m_RenderCullHasOrtho = false;
     }
     void GameObjectPool::DoRender()
     {
         GetObjectTable(G_L); // ot
         int const ot_idx = lua_gettop(G_L);
+        lua_rawgeti(G_L, ot_idx, LOBJPOOL_CLASSCACHE_IDX); // ot cc
+        int const cc_idx = lua_gettop(G_L);
 
         m_IsRendering = true;
         m_pCurrentObject = nullptr;
+        m_RenderBatch.Reset();
     #ifdef USING_MULTI_GAME_WORLD
         lua_Integer world = GetWorldFlag();
     #endif // USING_MULTI_GAME_WORLD
-        for (auto& p : m_RenderList)
+        m_RenderList.ForEach([&](GameObject* p)
         {
     #ifdef USING_MULTI_GAME_WORLD
             if (!p->hide && CheckWorld(p->world, world))  // 只渲染可见对象
@@ -372,12 +926,27 @@ namespace LuaSTGPlus
             if (!p->hide)  // 只渲染可见对象
     #endif // USING_MULTI_GAME_WORLD
             {
+                // 相机可能在渲染回调中被修改，每个对象都要用当前的剔除矩形判断
+                if (m_RenderCull && _IsRenderCulled(p))
+                {
+                    m_DbgData[m_DbgIdx].object_render_culled += 1;
+                    return;
+                }
+                // 连续的默认渲染精灵、动画对象直接写入绘制列表，共用纹理和混合模式的设置
+                if (GameObjectRenderBatch::IsBatchable(p))
+                {
+                    m_RenderBatch.Draw(p);
+                    m_DbgData[m_DbgIdx].object_render_batched += 1;
+                    return;
+                }
+                // 其他渲染方式可能修改渲染状态
+                m_RenderBatch.Reset();
                 m_pCurrentObject = p;
     #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
                 if (!p->luaclass.IsDefaultRender)
                 {
     #endif // USING_ADVANCE_GAMEOBJECT_CLASS
-                    _GameObjectCallback(G_L, ot_idx, p, LGOBJ_CC_RENDER);
+                    _GameObjectCallback(G_L, ot_idx, cc_idx, p, LGOBJ_CC_RENDER);
     #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
                 }
                 else
@@ -386,11 +955,11 @@ namespace LuaSTGPlus
                 }
     #endif // USING_ADVANCE_GAMEOBJECT_CLASS
             }
-        }
+        });
         m_pCurrentObject = nullptr;
         m_IsRendering = false;
 
-        lua_pop(G_L, 1);
+        lua_pop(G_L, 2);
     }
     void GameObjectPool::BoundCheck()
     {
@@ -398,213 +967,2142 @@ namespace LuaSTGPlus
 
         GetObjectTable(G_L); // ot
         int const ot_idx = lua_gettop(G_L);
-        
+        lua_rawgeti(G_L, ot_idx, LOBJPOOL_CLASSCACHE_IDX); // ot cc
+        int const cc_idx = lua_gettop(G_L);
+
+        _BoundCheck(ot_idx, cc_idx);
+
+        lua_pop(G_L, 2);
+    }
+    void GameObjectPool::_BoundCheck(int ot_idx, int cc_idx)
+    {
+        _IterationScope const scope(*this);
         m_pCurrentObject = nullptr;
     #ifdef USING_MULTI_GAME_WORLD
         lua_Integer world = GetWorldFlag();
     #endif // USING_MULTI_GAME_WORLD
         for (GameObject* p = m_UpdateLinkList.first.pUpdateNext; p != &m_UpdateLinkList.second; p = p->pUpdateNext)
         {
-        #ifdef USING_MULTI_GAME_WORLD
-            if (CheckWorld(p->world, world))
+        #ifdef USING_MULTI_GAME_WORLD
+            if (CheckWorld(p->world, world))
+            {
+        #endif // USING_MULTI_GAME_WORLD
+                if (!_ObjectBoundCheck(p))
+                {
+                    m_pCurrentObject = p;
+                    // 越界设置为 del 状态
+                    p->status = GameObjectStatus::Dead;
+                    // 调用 del callback
+                #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+                    if (!p->luaclass.IsDefaultDestroy)
+                    {
+                #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+                        _GameObjectCallback(G_L, ot_idx, cc_idx, p, LGOBJ_CC_DEL);
+                #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+                    }
+                #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+                }
+        #ifdef USING_MULTI_GAME_WORLD
+            }
+        #endif // USING_MULTI_GAME_WORLD
+        }
+        m_pCurrentObject = nullptr;
+    }
+    GameObjectSpatialGrid* GameObjectPool::_PrepareColliGrid(size_t group)
+    {
+        GameObjectSpatialGrid& grid = m_ColliGrid[group];
+        if (!grid.IsBuilt() || grid.GetVersion() != m_ColliGroupVersion[group])
+        {
+            ZoneScopedN("LOBJMGR.CollisionCheck.Broadphase");
+            grid.Build(m_ColliLinkList[group].first.pColliNext, &m_ColliLinkList[group].second, m_ColliBroadphaseCellSize, m_ColliGroupVersion[group]);
+        }
+        return &grid;
+    }
+    GameObjectSpatialGrid* GameObjectPool::_PrepareQueryGrid(size_t group)
+    {
+        GameObjectSpatialGrid& grid = m_QueryGrid[group];
+        if (!grid.IsBuilt() || grid.GetVersion() != m_ColliGroupVersion[group])
+        {
+            // DoFrame 期间每个碰撞组只建立一次网格，见 _QueryGridFreezeScope
+            if (grid.IsBuilt() && m_QueryGridFrozen && m_QueryGridFrame[group] == m_QueryGridFrozen)
+                return &grid;
+            ZoneScopedN("LOBJMGR.Query.Build");
+            grid.Build(m_ColliLinkList[group].first.pColliNext, &m_ColliLinkList[group].second, m_ColliBroadphaseCellSize, m_ColliGroupVersion[group]);
+            m_QueryGridFrame[group] = m_QueryGridFrozen;
+        }
+        return &grid;
+    }
+    void GameObjectPool::_QueryCandidates(lua_Integer group, float l, float r, float b, float t, std::vector<GameObject*>& out)
+    {
+        out.clear();
+        if (0 <= group && group < LOBJPOOL_GROUPN)
+        {
+            GameObjectSpatialGrid* grid = _PrepareQueryGrid((size_t)group);
+            grid->QueryRect(l, r, b, t, m_QueryCandidate);
+            for (uint32_t const i : m_QueryCandidate)
+            {
+                // 网格可能是这一帧早些时候建立的，对象可能已经被删除、复用或者换了碰撞组
+                GameObject* p = grid->GetObject(i);
+                if (p->status == GameObjectStatus::Active && p->group == group)
+                    out.push_back(p);
+            }
+        }
+        else
+        {
+            // 不是有效的碰撞组时查询所有对象，按更新顺序
+            for (GameObject* p = m_UpdateLinkList.first.pUpdateNext; p != &m_UpdateLinkList.second; p = p->pUpdateNext)
+            {
+                if (p->status == GameObjectStatus::Active && p->IsInRect(l, r, b, t))
+                    out.push_back(p);
+            }
+        }
+    }
+    int GameObjectPool::_PushQueryResult(lua_State* L, std::vector<GameObject*> const& list, int callback_idx)
+    {
+        GetObjectTable(L);											// ??? ot
+        int const ot_idx = lua_gettop(L);
+        if (callback_idx == 0)
+        {
+            lua_createtable(L, (int)list.size(), 0);				// ??? ot t
+            for (size_t i = 0; i < list.size(); i += 1)
+            {
+                lua_rawgeti(L, ot_idx, (int)list[i]->id + 1);		// ??? ot t object
+                lua_rawseti(L, -2, (int)i + 1);						// ??? ot t
+            }
+            lua_remove(L, ot_idx);									// ??? t
+            return 1;
+        }
+        // 回调可能删除或移动对象，先记录 uid，跳过已经失效的对象
+        std::vector<std::pair<GameObject*, uint64_t>> targets;
+        targets.reserve(list.size());
+        for (GameObject* p : list)
+            targets.emplace_back(p, p->uid);
+        lua_Integer count = 0;
+        for (auto const& [p, uid] : targets)
+        {
+            if (p->uid != uid || p->status != GameObjectStatus::Active)
+                continue;
+            lua_pushvalue(L, callback_idx);							// ??? ot f
+            lua_rawgeti(L, ot_idx, (int)p->id + 1);					// ??? ot f object
+            lua_call(L, 1, 0);										// ??? ot
+            count += 1;
+        }
+        lua_pop(L, 1);												// ???
+        lua_pushinteger(L, count);									// ??? n
+        return 1;
+    }
+    int GameObjectPool::QueryCircle(lua_State* L, lua_Integer group, float x, float y, float radius, bool sorted, int callback_idx)
+    {
+        ZoneScopedN("LOBJMGR.QueryCircle");
+
+        std::vector<GameObject*> list;
+        list.swap(m_QueryResultCache);
+        _QueryCandidates(group, x - radius, x + radius, y - radius, y + radius, list);
+        float const r2 = radius * radius;
+        std::erase_if(list, [&](GameObject const* p)
+        {
+            float const dx = p->x - x;
+            float const dy = p->y - y;
+            return dx * dx + dy * dy > r2;
+        });
+        if (sorted)
+        {
+            // 距离相同时保持原来的顺序
+            std::stable_sort(list.begin(), list.end(), [&](GameObject const* a, GameObject const* b)
+            {
+                float const adx = a->x - x;
+                float const ady = a->y - y;
+                float const bdx = b->x - x;
+                float const bdy = b->y - y;
+                return adx * adx + ady * ady < bdx * bdx + bdy * bdy;
+            });
+        }
+        int const result = _PushQueryResult(L, list, callback_idx);
+        list.clear();
+        list.swap(m_QueryResultCache);
+        return result;
+    }
+    int GameObjectPool::QueryRect(lua_State* L, lua_Integer group, float l, float r, float b, float t, int callback_idx)
+    {
+        ZoneScopedN("LOBJMGR.QueryRect");
+
+        std::vector<GameObject*> list;
+        list.swap(m_QueryResultCache);
+        _QueryCandidates(group, l, r, b, t, list);
+        std::erase_if(list, [&](GameObject const* p) { return !p->IsInRect(l, r, b, t); });
+        int const result = _PushQueryResult(L, list, callback_idx);
+        list.clear();
+        list.swap(m_QueryResultCache);
+        return result;
+    }
+    int GameObjectPool::QueryNearest(lua_State* L, lua_Integer group, float x, float y, float max_dist)
+    {
+        ZoneScopedN("LOBJMGR.QueryNearest");
+
+        GameObject* nearest = nullptr;
+        float nearest_d2 = std::numeric_limits<float>::infinity();
+        auto const visit = [&](GameObject* p)
+        {
+            float const dx = p->x - x;
+            float const dy = p->y - y;
+            float const d2 = dx * dx + dy * dy;
+            if (d2 < nearest_d2)
+            {
+                nearest = p;
+                nearest_d2 = d2;
+            }
+        };
+        if (std::isfinite(max_dist))
+        {
+            std::vector<GameObject*> list;
+            list.swap(m_QueryResultCache);
+            _QueryCandidates(group, x - max_dist, x + max_dist, y - max_dist, y + max_dist, list);
+            nearest_d2 = max_dist * max_dist;
+            nearest_d2 = std::nextafter(nearest_d2, std::numeric_limits<float>::infinity()); // 包含正好在最大距离上的对象
+            std::for_each(list.begin(), list.end(), visit);
+            list.clear();
+            list.swap(m_QueryResultCache);
+        }
+        else if (0 <= group && group < LOBJPOOL_GROUPN)
+        {
+            for (GameObject* p = m_ColliLinkList[(size_t)group].first.pColliNext; p != &m_ColliLinkList[(size_t)group].second; p = p->pColliNext)
+            {
+                if (p->status == GameObjectStatus::Active)
+                    visit(p);
+            }
+        }
+        else
+        {
+            for (GameObject* p = m_UpdateLinkList.first.pUpdateNext; p != &m_UpdateLinkList.second; p = p->pUpdateNext)
+            {
+                if (p->status == GameObjectStatus::Active)
+                    visit(p);
+            }
+        }
+        if (!nearest)
+        {
+            lua_pushnil(L);
+            return 1;
+        }
+        GetObjectTable(L);								// ??? ot
+        lua_rawgeti(L, -1, (int)nearest->id + 1);		// ??? ot object
+        lua_remove(L, -2);								// ??? object
+        lua_pushnumber(L, std::sqrt(nearest_d2));		// ??? object d
+        return 2;
+    }
+    bool GameObjectPool::_CollisionCheckPair(int ot_idx, int cc_idx, CollisionPair const& pair, GameObject* pA, GameObject* pB, GameObject* pNextB)
+    {
+        if (!_CheckCollisionWorlds(pair, pA, pB))
+            return false;
+        m_DbgData[m_DbgIdx].object_colli_check += 1;
+        if (!LuaSTGPlus::CollisionCheck(pA, pB))
+            return false;
+        m_DbgData[m_DbgIdx].object_colli_callback += 1;
+        m_pCurrentObject = pA;
+
+        // TODO: 是否有必要这样？其实相当于关闭了判定吧？
+    #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+        if (pA->luaclass.IsDefaultTrigger)
+            return false;
+    #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+
+        m_LockObjectB = pNextB;
+
+    #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+        if (pA->luaclass.CacheIndex != 0)
+        {
+            // 直接从类缓存中取 collifunc
+            lua_rawgeti(G_L, cc_idx, (int)pA->luaclass.CacheIndex * LOBJPOOL_CLASSCACHE_STRIDE + LGOBJ_CC_COLLI);	// ot cc ??? f(colli)
+            lua_rawgeti(G_L, ot_idx, (int)pA->id + 1);	// ot cc ??? f(colli) t(object)
+            lua_rawgeti(G_L, ot_idx, (int)pB->id + 1);	// ot cc ??? f(colli) t(object) t(object)
+            lua_call(G_L, 2, 0);						// ot cc ???
+            m_LockObjectB = nullptr;
+            return true;
+        }
+    #else // USING_ADVANCE_GAMEOBJECT_CLASS
+        std::ignore = cc_idx;
+    #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+
+        // 根据id获取对象的lua绑定table、拿到class再拿到collifunc
+        lua_rawgeti(G_L, ot_idx, (int)pA->id + 1);	// ot ??? t(object)
+        lua_rawgeti(G_L, -1, 1);					// ot ??? t(object) t(class)
+        lua_rawgeti(G_L, -1, LGOBJ_CC_COLLI);		// ot ??? t(object) t(class) f(colli)
+        lua_pushvalue(G_L, -3);						// ot ??? t(object) t(class) f(colli) t(object)
+        lua_rawgeti(G_L, ot_idx, (int)pB->id + 1);	// ot ??? t(object) t(class) f(colli) t(object) t(object)
+        lua_call(G_L, 2, 0);						// ot ??? t(object) t(class)
+        lua_pop(G_L, 2);							// ot ???
+
+        m_LockObjectB = nullptr;
+        return true;
+    }
+    void GameObjectPool::_CollectCollisionHits(CollisionPair const& pair, std::vector<CollisionHit>& hits)
+    {
+        size_t const groupA = pair.group_a;
+        size_t const groupB = pair.group_b;
+        hits.clear();
+
+        // 收集阶段不执行 lua 代码，宽相位网格始终可信
+        GameObjectSpatialGrid const* grid = m_ColliBroadphase ? _PrepareColliGrid(groupB) : nullptr;
+
+        m_ColliListA.clear();
+        for (GameObject* p = m_ColliLinkList[groupA].first.pColliNext; p != &m_ColliLinkList[groupA].second; p = p->pColliNext)
+            m_ColliListA.push_back(p);
+        m_ColliListB.clear();
+        if (!grid)
+        {
+            for (GameObject* p = m_ColliLinkList[groupB].first.pColliNext; p != &m_ColliLinkList[groupB].second; p = p->pColliNext)
+                m_ColliListB.push_back(p);
+        }
+        size_t const nA = m_ColliListA.size();
+        size_t const nB = m_ColliListB.size();
+
+        // 检测 A 组 [a0, a1) 与 B 组 [b0, b1) 的对象，有宽相位网格时忽略 B 组范围
+        auto const collect = [this, grid, &pair](size_t a0, size_t a1, size_t b0, size_t b1, CollisionChunk& chunk)
+        {
+            auto const test = [&](GameObject* pA, GameObject* pB)
+            {
+                if (!_CheckCollisionWorlds(pair, pA, pB))
+                    return;
+                chunk.checks += 1;
+                if (LuaSTGPlus::CollisionCheck(pA, pB))
+                    chunk.hits.push_back(CollisionHit{ pA, pB, pA->uid, pB->uid, 0 });
+            };
+            for (size_t a = a0; a < a1; a += 1)
+            {
+                GameObject* pA = m_ColliListA[a];
+                if (grid)
+                {
+                    grid->Query(pA, chunk.candidate);
+                    for (uint32_t const i : chunk.candidate)
+                        test(pA, grid->GetObject(i));
+                }
+                else
+                {
+                    for (size_t b = b0; b < b1; b += 1)
+                        test(pA, m_ColliListB[b]);
+                }
+            }
+        };
+
+        // 工作量足够大时拆分到工作线程；每个任务的结果按任务顺序拼接，与逐个检测的顺序一致
+        size_t const threads = m_ColliWorkers.GetThreadCount();
+        size_t const work = grid ? nA * 16 : nA * nB;
+        size_t a_slices = 1;
+        size_t b_slices = 1;
+        if (threads > 0 && nA > 0 && work >= COLLI_PARALLEL_MIN_WORK)
+        {
+            size_t const task_target = (threads + 1) * 4;
+            if (grid || nA >= task_target)
+            {
+                a_slices = std::min(nA, task_target);
+            }
+            else
+            {
+                // A 组对象很少（例如自机），拆分 B 组
+                a_slices = nA;
+                b_slices = std::clamp<size_t>(task_target / nA, 1, std::max<size_t>(nB / 64, 1));
+            }
+        }
+        size_t const task_count = a_slices * b_slices;
+        if (m_ColliChunks.size() < task_count)
+            m_ColliChunks.resize(task_count);
+
+        if (task_count == 1)
+        {
+            CollisionChunk& chunk = m_ColliChunks[0];
+            chunk.hits.clear();
+            chunk.checks = 0;
+            collect(0, nA, 0, nB, chunk);
+        }
+        else
+        {
+            ZoneScopedN("LOBJMGR.CollisionCheck.Parallel");
+            m_ColliWorkers.Run(task_count, [&](size_t t)
+            {
+                size_t const ai = t / b_slices;
+                size_t const bi = t % b_slices;
+                CollisionChunk& chunk = m_ColliChunks[t];
+                chunk.hits.clear();
+                chunk.checks = 0;
+                collect(nA * ai / a_slices, nA * (ai + 1) / a_slices, nB * bi / b_slices, nB * (bi + 1) / b_slices, chunk);
+            });
+        }
+
+        for (size_t t = 0; t < task_count; t += 1)
+        {
+            CollisionChunk const& chunk = m_ColliChunks[t];
+            m_DbgData[m_DbgIdx].object_colli_check += chunk.checks;
+            m_DbgData[m_DbgIdx].object_colli_callback += chunk.hits.size();
+            hits.insert(hits.end(), chunk.hits.begin(), chunk.hits.end());
+        }
+    }
+    void GameObjectPool::_DispatchCollisionHits(int ot_idx, std::vector<CollisionHit>& hits, bool group_by_class)
+    {
+        // TODO: 是否有必要这样？其实相当于关闭了判定吧？
+    #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+        std::erase_if(hits, [](CollisionHit const& h) { return h.a->luaclass.IsDefaultTrigger; });
+    #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+        if (hits.empty())
+            return;
+        lua_rawgeti(G_L, ot_idx, LOBJPOOL_CLASSCACHE_IDX);	// ot ??? cc
+        int const cc_idx = lua_gettop(G_L);
+
+        // 已缓存的类直接从类缓存中取类和 collifunc，与 _CollisionCheckPair 相同
+        auto const push_class = [this, ot_idx, cc_idx](GameObject const* p, int slot)
+        {
+        #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+            if (p->luaclass.CacheIndex != 0)
+            {
+                lua_rawgeti(G_L, cc_idx, (int)p->luaclass.CacheIndex * LOBJPOOL_CLASSCACHE_STRIDE + slot);	// ot ??? cc v
+                return;
+            }
+        #else // USING_ADVANCE_GAMEOBJECT_CLASS
+            std::ignore = cc_idx;
+        #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+            lua_rawgeti(G_L, ot_idx, (int)p->id + 1);	// ot ??? cc t(object)
+            lua_rawgeti(G_L, -1, 1);					// ot ??? cc t(object) t(class)
+            if (slot != 0)
+                lua_rawgeti(G_L, -1, slot);				// ot ??? cc t(object) t(class) f
+            else
+                lua_pushvalue(G_L, -1);					// ot ??? cc t(object) t(class) t(class)
+            lua_replace(G_L, -3);						// ot ??? cc v t(class)
+            lua_pop(G_L, 1);							// ot ??? cc v
+        };
+
+        // 按 A 的类分组，组的顺序为类首次出现的顺序，组内保持检测顺序，保证结果可复现；
+        // 不分组时按检测顺序派发，连续的同类对象共用一次 collifunc 查找
+        std::vector<void const*> classes;
+        GameObject* last = nullptr;
+        uint32_t order = 0;
+        for (auto& h : hits)
+        {
+            if (h.a != last)
+            {
+                push_class(h.a, 0);							// ot ??? cc t(class)
+                void const* const cls = lua_topointer(G_L, -1);
+                lua_pop(G_L, 1);							// ot ??? cc
+                auto const it = std::find(classes.begin(), classes.end(), cls);
+                order = (uint32_t)(it - classes.begin());
+                if (it == classes.end())
+                    classes.push_back(cls);
+                last = h.a;
+            }
+            h.order = order;
+        }
+        if (group_by_class && classes.size() > 1)
+        {
+            std::stable_sort(hits.begin(), hits.end(), [](CollisionHit const& x, CollisionHit const& y) { return x.order < y.order; });
+        }
+
+        // 回调可能回收对象或关闭碰撞，派发前检查对象是否仍然有效并且仍然参与碰撞，与逐对检测一致
+        auto const is_valid = [](CollisionHit const& h) -> bool
+        {
+            return h.a->status != GameObjectStatus::Free && h.a->uid == h.uid_a
+                && h.b->status != GameObjectStatus::Free && h.b->uid == h.uid_b
+                && h.a->colli && h.b->colli;
+        };
+
+        // 每组只取一次 collifunc
+        for (size_t i = 0; i < hits.size();)
+        {
+            size_t j = i;
+            while (j < hits.size() && hits[j].order == hits[i].order)
+            {
+                j += 1;
+            }
+            size_t first = i;
+            while (first < j && !is_valid(hits[first]))
+            {
+                first += 1;
+            }
+            if (first < j)
+            {
+                push_class(hits[first].a, LGOBJ_CC_COLLI);				// ot ??? cc f(colli)
+                int const f_idx = lua_gettop(G_L);
+                for (size_t k = first; k < j; k += 1)
+                {
+                    CollisionHit const& h = hits[k];
+                    if (!is_valid(h))
+                        continue;
+                    m_pCurrentObject = h.a;
+                    lua_pushvalue(G_L, f_idx);							// ot ??? cc f(colli) f(colli)
+                    lua_rawgeti(G_L, ot_idx, (int)h.a->id + 1);		// ot ??? cc f(colli) f(colli) t(object)
+                    lua_rawgeti(G_L, ot_idx, (int)h.b->id + 1);		// ot ??? cc f(colli) f(colli) t(object) t(object)
+                    lua_call(G_L, 2, 0);								// ot ??? cc f(colli)
+                }
+                lua_pop(G_L, 1);										// ot ??? cc
+            }
+            i = j;
+        }
+        m_pCurrentObject = nullptr;
+        lua_pop(G_L, 1);												// ot ???
+    }
+    void GameObjectPool::_CollisionCheck(int ot_idx, CollisionPair const& pair)
+    {
+        _IterationScope const scope(*this);
+        size_t const groupA = pair.group_a;
+        size_t const groupB = pair.group_b;
+
+        if (m_ColliBatchDispatch || m_ColliWorkers.GetThreadCount() > 0)
+        {
+            // 先收集所有碰撞对，再在主线程上派发回调；回调中可能再次调用碰撞检测，所以借用缓冲区而不是直接使用
+            std::vector<CollisionHit> hits;
+            hits.swap(m_ColliHitsCache);
+            _CollectCollisionHits(pair, hits);
+            _DispatchCollisionHits(ot_idx, hits, m_ColliBatchDispatch);
+            hits.swap(m_ColliHitsCache);
+            return;
+        }
+
+        // 宽相位网格只在 A、B 组都没有被修改时可信，否则回退到逐个遍历剩余的 B 组对象，
+        // 保证结果和回调顺序与逐对检测完全一致；候选对象是按 A 对象检测前的范围查询的，回调中移动或缩放 A 对象后同样不可信；
+        // 回调中嵌套的碰撞检测可能重建网格，候选序号随之失效，所以同时检查碰撞组版本和网格的构建次数
+        bool const use_broadphase = m_ColliBroadphase;
+        std::vector<uint32_t> candidate;
+        lua_rawgeti(G_L, ot_idx, LOBJPOOL_CLASSCACHE_IDX); // ot cc
+        int const cc_idx = lua_gettop(G_L);
+
+        m_pCurrentObject = nullptr;
+        for (GameObject* ptrA = m_ColliLinkList[groupA].first.pColliNext; ptrA != &m_ColliLinkList[groupA].second;)
+        {
+            GameObject* pA = ptrA;
+            ptrA = ptrA->pColliNext;
+
+            m_LockObjectA = ptrA;
+
+            GameObject* ptrB = m_ColliLinkList[groupB].first.pColliNext;
+            if (use_broadphase)
+            {
+                GameObjectSpatialGrid* grid = _PrepareColliGrid(groupB);
+                uint64_t const version_a = m_ColliGroupVersion[groupA];
+                uint64_t const version = m_ColliGroupVersion[groupB];
+                uint64_t const generation = grid->GetGeneration();
+                grid->Query(pA, candidate);
+                ptrB = &m_ColliLinkList[groupB].second;
+                for (uint32_t const i : candidate)
+                {
+                    GameObject* pB = grid->GetObject(i);
+                    GameObject* pNextB = pB->pColliNext;
+                    if (_CollisionCheckPair(ot_idx, cc_idx, pair, pA, pB, pNextB)
+                        && (m_ColliGroupVersion[groupA] != version_a || m_ColliGroupVersion[groupB] != version || grid->GetGeneration() != generation))
+                    {
+                        // A 组或 B 组已改变，剩余部分逐个检测
+                        ptrB = pNextB;
+                        break;
+                    }
+                }
+            }
+            while (ptrB != &m_ColliLinkList[groupB].second)
+            {
+                GameObject* pB = ptrB;
+                ptrB = ptrB->pColliNext;
+                _CollisionCheckPair(ot_idx, cc_idx, pair, pA, pB, ptrB);
+            }
+
+            m_LockObjectA = nullptr;
+        }
+        m_pCurrentObject = nullptr;
+        lua_pop(G_L, 1);
+    }
+    void GameObjectPool::CollisionCheck(size_t groupA, size_t groupB)
+    {
+        ZoneScopedN("LOBJMGR.CollisionCheck");
+
+        if (groupA >= LOBJPOOL_GROUPN || groupB >= LOBJPOOL_GROUPN)
+            luaL_error(G_L, "Invalid collision group.");
+
+        GetObjectTable(G_L); // ot
+        int const ot_idx = lua_gettop(G_L);
+
+        _CollisionCheck(ot_idx, CollisionPair{ groupA, groupB, 0, false });
+
+        lua_pop(G_L, 1);
+    }
+    void GameObjectPool::SetCollisionPairs(std::vector<CollisionPair> const& pairs)
+    {
+        for (auto const& pair : pairs)
+        {
+            if (pair.group_a >= LOBJPOOL_GROUPN || pair.group_b >= LOBJPOOL_GROUPN)
+                luaL_error(G_L, "Invalid collision group.");
+        }
+        m_ColliPairs = pairs;
+    }
+    void GameObjectPool::CollisionCheckAll()
+    {
+        ZoneScopedN("LOBJMGR.CollisionCheckAll");
+
+        GetObjectTable(G_L); // ot
+        int const ot_idx = lua_gettop(G_L);
+
+        _CollisionCheckAll(ot_idx);
+
+        lua_pop(G_L, 1);
+    }
+    void GameObjectPool::_CollisionCheckAll(int ot_idx)
+    {
+        // 回调中可能修改碰撞对表，按序号访问并复制当前的碰撞对
+        for (size_t i = 0; i < m_ColliPairs.size(); i += 1)
+        {
+            CollisionPair const pair = m_ColliPairs[i];
+            FrameStatistics& stat = m_DbgData[m_DbgIdx];
+            uint64_t const check = stat.object_colli_check;
+            uint64_t const callback = stat.object_colli_callback;
+            auto const t0 = std::chrono::high_resolution_clock::now();
+            _CollisionCheck(ot_idx, pair);
+            auto const t1 = std::chrono::high_resolution_clock::now();
+            if (i < std::size(stat.colli_pair))
+            {
+                CollisionPairStatistics& pair_stat = stat.colli_pair[i];
+                pair_stat.group_a = (uint32_t)pair.group_a;
+                pair_stat.group_b = (uint32_t)pair.group_b;
+                pair_stat.check += stat.object_colli_check - check;
+                pair_stat.callback += stat.object_colli_callback - callback;
+                pair_stat.time += std::chrono::duration<double, std::milli>(t1 - t0).count();
+                stat.colli_pair_count = std::max(stat.colli_pair_count, (uint32_t)(i + 1));
+            }
+        }
+    }
+    int GameObjectPool::CollisionCheckList(lua_State* L, size_t groupA, size_t groupB)
+    {
+        ZoneScopedN("LOBJMGR.CollisionCheckList");
+
+        if (groupA >= LOBJPOOL_GROUPN || groupB >= LOBJPOOL_GROUPN)
+            return luaL_error(L, "Invalid collision group.");
+
+        std::vector<CollisionHit> hits;
+        hits.swap(m_ColliHitsCache);
+        _CollectCollisionHits(CollisionPair{ groupA, groupB, 0, false }, hits);
+
+        int const n = (int)hits.size();
+        GetObjectTable(L);				// ot
+        int const ot_idx = lua_gettop(L);
+        lua_createtable(L, n, 0);		// ot ta
+        lua_createtable(L, n, 0);		// ot ta tb
+        for (int i = 0; i < n; i += 1)
+        {
+            lua_rawgeti(L, ot_idx, (int)hits[(size_t)i].a->id + 1);	// ot ta tb t(object)
+            lua_rawseti(L, ot_idx + 1, i + 1);							// ot ta tb
+            lua_rawgeti(L, ot_idx, (int)hits[(size_t)i].b->id + 1);	// ot ta tb t(object)
+            lua_rawseti(L, ot_idx + 2, i + 1);							// ot ta tb
+        }
+        lua_remove(L, ot_idx);			// ta tb
+        lua_pushinteger(L, n);			// ta tb n
+
+        hits.swap(m_ColliHitsCache);
+        return 3;
+    }
+    void GameObjectPool::UpdateXY() noexcept
+    {
+        ZoneScopedN("LOBJMGR.UpdateXY");
+
+        int superpause = GetSuperPauseTime();
+        for (GameObject* p = m_UpdateLinkList.first.pUpdateNext; p != &m_UpdateLinkList.second; p = p->pUpdateNext)
+        {
+            if (superpause <= 0 || p->ignore_superpause)
+            {
+                p->UpdateLast();
+            }
+        }
+        _MarkAllColliGroupDirty(); // 连续碰撞检测的范围随上一帧坐标改变
+    }
+    void GameObjectPool::AfterFrame()
+    {
+        ZoneScopedN("LOBJMGR.AfterFrame");
+
+        GetObjectTable(G_L);
+        int const ot_at = lua_gettop(G_L);
+
+        int superpause = GetSuperPauseTime();
+        for (GameObject* p = m_UpdateLinkList.first.pUpdateNext; p != &m_UpdateLinkList.second;)
+        {
+            if (superpause <= 0 || p->ignore_superpause)
+            {
+                p->UpdateTimer();
+                if (p->status != GameObjectStatus::Active)
+                {
+                    p = _FreeObject(p, ot_at); // 再下一个
+                }
+                else
+                {
+                    p = p->pUpdateNext;
+                }
+            }
+            else
+            {
+                p = p->pUpdateNext;
+            }
+        }
+
+        // 每帧合并一次渲染列表的修改，即使这一帧不渲染
+        m_RenderList.Flush();
+
+        lua_pop(G_L, 1);
+    }
+    void GameObjectPool::_UpdateXYAndAfterFrame(int ot_at)
+    {
+        // 两个阶段都只修改对象自身，不执行 lua 代码，逐个对象完成与分成两次遍历的结果相同
+        int superpause = GetSuperPauseTime();
+        for (GameObject* p = m_UpdateLinkList.first.pUpdateNext; p != &m_UpdateLinkList.second;)
+        {
+            if (superpause <= 0 || p->ignore_superpause)
+            {
+                p->UpdateLast();
+                p->UpdateTimer();
+                if (p->status != GameObjectStatus::Active)
+                {
+                    p = _FreeObject(p, ot_at); // 再下一个
+                    continue;
+                }
+            }
+            p = p->pUpdateNext;
+        }
+
+        // 每帧合并一次渲染列表的修改，即使这一帧不渲染
+        m_RenderList.Flush();
+        _MarkAllColliGroupDirty(); // 连续碰撞检测的范围随上一帧坐标改变
+    }
+    int GameObjectPool::Step(lua_State* L, bool collision)
+    {
+        ZoneScopedN("LOBJMGR.ObjStep");
+
+        using clock = std::chrono::high_resolution_clock;
+
+        GetObjectTable(G_L); // ot
+        int const ot_idx = lua_gettop(G_L);
+        lua_rawgeti(G_L, ot_idx, LOBJPOOL_CLASSCACHE_IDX); // ot cc
+        int const cc_idx = lua_gettop(G_L);
+
+        // frame 回调可能移动其他对象，边界检查和碰撞检测必须在所有 frame 回调之后进行，
+        // 只有 UpdateXY 和 AfterFrame 可以合并为一次遍历
+        auto const t0 = clock::now();
+        {
+            ZoneScopedN("LOBJMGR.ObjStep.Frame");
+            _DoFrame(ot_idx, cc_idx);
+        }
+        auto const t1 = clock::now();
+        {
+            ZoneScopedN("LOBJMGR.ObjStep.BoundCheck");
+            _BoundCheck(ot_idx, cc_idx);
+        }
+        auto const t2 = clock::now();
+        if (collision)
+        {
+            ZoneScopedN("LOBJMGR.ObjStep.CollisionCheck");
+            _CollisionCheckAll(ot_idx);
+        }
+        auto const t3 = clock::now();
+        {
+            ZoneScopedN("LOBJMGR.ObjStep.AfterFrame");
+            _UpdateXYAndAfterFrame(ot_idx);
+        }
+        auto const t4 = clock::now();
+
+        lua_pop(G_L, 2);
+
+        double const times[4] = {
+            std::chrono::duration<double, std::milli>(t1 - t0).count(),
+            std::chrono::duration<double, std::milli>(t2 - t1).count(),
+            std::chrono::duration<double, std::milli>(t3 - t2).count(),
+            std::chrono::duration<double, std::milli>(t4 - t3).count(),
+        };
+        FrameStatistics& stat = m_DbgData[m_DbgIdx];
+        for (size_t i = 0; i < std::size(times); i += 1)
+        {
+            stat.step_time[i] += times[i];
+            lua_pushnumber(L, times[i]);
+        }
+        return (int)std::size(times);
+    }
+
+    int GameObjectPool::New(lua_State* L)
+    {
+        // 检查参数
+        if (!GameObjectClass::CheckClassValid(L, 1))
+        {
+            return luaL_error(L, "invalid argument #1, luastg object class required for 'New'.");
+        }
+
+        // 分配一个对象
+        GameObject* p = _AllocObject();
+        if (p == nullptr)
+        {
+            return luaL_error(L, "can't alloc object, object pool may be full.");
+        }
+
+        //											// class ...
+
+        // 创建对象 table
+        GetObjectTable(L);							// class ... ot
+    #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+        _ResolveClass(L, 1, lua_gettop(L), p->luaclass);
+    #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+        _NewObjectTable(L, lua_gettop(L));			// class ... ot object
+        lua_pushvalue(L, 1);						// class ... ot object class
+        lua_rawseti(L, -2, 1);						// class ... ot object
+        lua_pushinteger(L, (lua_Integer)p->id);		// class ... ot object id
+        lua_rawseti(L, -2, 2);						// class ... ot object
+        lua_pushlightuserdata(L, p);				// class ... ot object pGameObject
+        lua_rawseti(L, -2, 3);						// class ... ot object
+        lua_pushinteger(L, (lua_Integer)p->uid);	// class ... ot object uid
+        lua_rawseti(L, -2, LOBJPOOL_OBJECT_UID_IDX);	// class ... ot object
+
+        // 设置对象 metatable
+        lua_rawgeti(L, -2, LOBJPOOL_METATABLE_IDX);	// class ... ot object mt
+        lua_setmetatable(L, -2);					// class ... ot object
+
+        // 设置到全局表 ot[n]
+        lua_pushvalue(L, -1);						// class ... ot object object
+        lua_rawseti(L, -3, (int)p->id + 1);			// class ... ot object
+
+    #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+        if (!p->luaclass.IsDefaultCreate)
+        {
+    #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+            // 调用 init
+            lua_insert(L, 1);							// object class ... ot
+            lua_pop(L, 1);								// object class ...
+            lua_rawgeti(L, 2, LGOBJ_CC_INIT);			// object class ... init
+            lua_insert(L, 3);							// object class init ...
+            lua_pushvalue(L, 1);						// object class init ... object
+            lua_insert(L, 4);							// object class init object ...
+            lua_call(L, lua_gettop(L) - 3, 0);			// object class
+            lua_pop(L, 1);								// object
+
+            // TODO: 潜在的 dx、dy 值问题，可能会导致意外情况
+            // 更新初始状态
+            //p->lastx = p->x;
+            //p->lasty = p->y;
+    #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+        }
+    #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+
+    #if (defined(_DEBUG) && defined(LuaSTG_enable_GameObjectManager_Debug))
+        static std::string _name("<null>");
+        spdlog::debug("[object] new {}-{} (img = {})", p->id, p->uid, p->res ? p->res->GetResName() : _name);
+    #endif
+
+        return 1;
+    }
+    int GameObjectPool::NewBatch(lua_State* L)
+    {
+        // 检查参数
+        if (!GameObjectClass::CheckClassValid(L, 1))
+        {
+            return luaL_error(L, "invalid argument #1, luastg object class required for 'NewBatch'.");
+        }
+        lua_Integer const n = luaL_checkinteger(L, 2);
+        if (n < 0)
+        {
+            return luaL_error(L, "invalid argument #2, object count must be non-negative.");
+        }
+        if ((size_t)n > m_ObjectPool.max_size() - m_ObjectPool.size())
+        {
+            return luaL_error(L, "can't alloc %lld objects, object pool may be full.", (long long)n);
+        }
+        if (!lua_isnoneornil(L, 3))
+        {
+            luaL_checktype(L, 3, LUA_TTABLE);
+        }
+        // params 之后的参数和 New 一样原样传给每个对象的 init
+        int const args_top = std::max(lua_gettop(L), 3);
+        lua_settop(L, args_top);										// class n params ...
+        int const nargs = args_top - 3;
+        // 字段数组、img 数组、对象 table、返回值和 init 调用同时在栈上
+        luaL_checkstack(L, 24 + nargs, "too many fields for 'NewBatch'.");
+
+        // 读取参数，每个字段可以是数值（所有对象相同）或数组（按序号取值）
+        struct Field
+        {
+            int table{ 0 };
+            lua_Number value{ 0.0 };
+            bool set{ false };
+        };
+        auto const read_field = [L](char const* name) -> Field
+        {
+            Field f;
+            if (lua_isnil(L, 3))
+                return f;
+            lua_getfield(L, 3, name);									// class n params ... v
+            if (lua_isnumber(L, -1))
+            {
+                f.value = lua_tonumber(L, -1);
+                f.set = true;
+                lua_pop(L, 1);											// class n params ...
+            }
+            else if (lua_istable(L, -1))
+            {
+                f.table = lua_gettop(L);								// class n params ... t
+                f.set = true;
+            }
+            else if (lua_isnil(L, -1))
+            {
+                lua_pop(L, 1);											// class n params ...
+            }
+            else
+            {
+                luaL_error(L, "invalid field '%s', number or array required.", name);
+            }
+            return f;
+        };
+        auto const get_field = [L](Field const& f, lua_Integer i, lua_Number def) -> lua_Number
+        {
+            if (!f.set)
+                return def;
+            if (f.table == 0)
+                return f.value;
+            lua_rawgeti(L, f.table, (int)i + 1);
+            lua_Number const v = lua_isnumber(L, -1) ? lua_tonumber(L, -1) : def;
+            lua_pop(L, 1);
+            return v;
+        };
+        Field const f_x = read_field("x");
+        Field const f_y = read_field("y");
+        Field const f_vx = read_field("vx");
+        Field const f_vy = read_field("vy");
+        Field const f_rot = read_field("rot");
+        Field const f_group = read_field("group");
+        Field const f_layer = read_field("layer");
+
+        // 生成器：ring 为整圆均匀分布，arc 从 angle 开始覆盖 spread，fan 以 angle 为中心覆盖 spread
+        // 每个对象沿分布方向偏移 radius，并叠加 speed 的速度，未指定 rot 时朝向分布方向
+        enum class Pattern { None, Ring, Arc, Fan } pattern = Pattern::None;
+        lua_Number angle = 0.0;
+        lua_Number spread = 0.0;
+        lua_Number speed = 0.0;
+        lua_Number radius = 0.0;
+        int img_idx = 0;
+        if (!lua_isnil(L, 3))
+        {
+            lua_getfield(L, 3, "pattern");
+            if (lua_isstring(L, -1))
+            {
+                std::string_view const name = luaL_check_string_view(L, -1);
+                if (name == "ring")
+                    pattern = Pattern::Ring;
+                else if (name == "arc")
+                    pattern = Pattern::Arc;
+                else if (name == "fan")
+                    pattern = Pattern::Fan;
+                else
+                    return luaL_error(L, "invalid pattern '%s', required 'ring', 'arc' or 'fan'.", name.data());
+            }
+            lua_pop(L, 1);
+            lua_getfield(L, 3, "angle");
+            angle = luaL_optnumber(L, -1, 0.0);
+            lua_getfield(L, 3, "spread");
+            spread = luaL_optnumber(L, -1, 0.0);
+            lua_getfield(L, 3, "speed");
+            speed = luaL_optnumber(L, -1, 0.0);
+            lua_getfield(L, 3, "radius");
+            radius = luaL_optnumber(L, -1, 0.0);
+            lua_pop(L, 4);
+            lua_getfield(L, 3, "img");									// class n params ... img
+            if (lua_isstring(L, -1) || lua_istable(L, -1))
+                img_idx = lua_gettop(L);
+            else
+                lua_pop(L, 1);
+        }
+
+        // 在分配任何对象之前读取所有字段、检查碰撞组并查找所有图像，之后的填充过程不会出错；
+        // init 回调可能修改参数中的数组，填充时只使用这里保存的值
+        struct Item
+        {
+            lua_Number x;
+            lua_Number y;
+            lua_Number vx;
+            lua_Number vy;
+            lua_Number rot;
+            lua_Number layer;
+            lua_Integer group;
+        };
+        std::vector<Item> items((size_t)n);
+        for (lua_Integer i = 0; i < n; i += 1)
+        {
+            Item& item = items[(size_t)i];
+            item.x = get_field(f_x, i, 0.0);
+            item.y = get_field(f_y, i, 0.0);
+            item.vx = get_field(f_vx, i, 0.0);
+            item.vy = get_field(f_vy, i, 0.0);
+            item.rot = get_field(f_rot, i, 0.0);
+            item.layer = get_field(f_layer, i, 0.0);
+            lua_Number const group = get_field(f_group, i, 0.0);
+            if (!(group >= 0 && group < LOBJPOOL_GROUPN)) // 同时排除 NaN
+                return luaL_error(L, "invalid argument for property 'group', required 0 <= group <= %d.", LOBJPOOL_GROUPN - 1);
+            item.group = (lua_Integer)group;
+        }
+        std::vector<Core::ScopeObject<IResourceBase>> resources;
+        if (img_idx != 0)
+        {
+            lua_Integer const count = lua_istable(L, img_idx) ? n : 1;
+            resources.resize((size_t)count);
+            for (lua_Integer i = 0; i < count; i += 1)
+            {
+                if (lua_istable(L, img_idx))
+                    lua_rawgeti(L, img_idx, (int)i + 1);				// class n params ... img
+                else
+                    lua_pushvalue(L, img_idx);							// class n params ... img
+                if (lua_isstring(L, -1))
+                {
+                    std::string_view const value = luaL_check_string_view(L, -1);
+                    resources[(size_t)i] = GameObject::FindResource(value);
+                    if (!resources[(size_t)i])
+                        return luaL_error(L, "can't find resource '%s' in image/animation/particle pool.", value.data());
+                }
+                lua_pop(L, 1);											// class n params ...
+            }
+        }
+
+        GetObjectTable(L);												// class n params ... ot
+        int const ot_idx = lua_gettop(L);
+    #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+        // 同一批对象的类相同，只需要解析一次
+        GameObjectClass luaclass;
+        _ResolveClass(L, 1, ot_idx, luaclass);
+        uint64_t class_generation = m_ClassCacheGeneration;
+    #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+        lua_createtable(L, (int)n, 0);									// class n params ... ot objects
+        int const ret_idx = lua_gettop(L);
+
+        for (lua_Integer i = 0; i < n; i += 1)
+        {
+            // 分配一个对象并创建对象 table
+            GameObject* p = _PushNewObject(L, 1, ot_idx);				// ... ot objects object
+            if (p == nullptr)
+            {
+                // 容量已经检查过，只有 init 中创建了其他对象时才会发生
+                return luaL_error(L, "can't alloc object, object pool may be full.");
+            }
+            int const obj_idx = lua_gettop(L);
+
+        #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+            if (class_generation != m_ClassCacheGeneration)
+            {
+                // init 中调用了 ResetPool，类缓存已经清空，重新解析
+                _ResolveClass(L, 1, ot_idx, luaclass);
+                class_generation = m_ClassCacheGeneration;
+            }
+            p->luaclass = luaclass;
+        #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+
+            // 填充属性
+            Item const& item = items[(size_t)i];
+            p->x = (float)item.x;
+            p->y = (float)item.y;
+            p->vx = (float)item.vx;
+            p->vy = (float)item.vy;
+            lua_Number rot = item.rot;
+            if (pattern != Pattern::None)
+            {
+                lua_Number a = angle;
+                switch (pattern)
+                {
+                case Pattern::Ring:
+                    a = angle + 360.0 * (lua_Number)i / (lua_Number)n;
+                    break;
+                case Pattern::Arc:
+                    a = angle + (n > 1 ? spread * (lua_Number)i / (lua_Number)(n - 1) : 0.0);
+                    break;
+                case Pattern::Fan:
+                    a = angle + (n > 1 ? spread * ((lua_Number)i / (lua_Number)(n - 1) - 0.5) : 0.0);
+                    break;
+                default:
+                    break;
+                }
+                lua_Number const c = std::cos(a * L_DEG_TO_RAD);
+                lua_Number const s = std::sin(a * L_DEG_TO_RAD);
+                p->x = (float)(p->x + radius * c);
+                p->y = (float)(p->y + radius * s);
+                p->vx = (float)(p->vx + speed * c);
+                p->vy = (float)(p->vy + speed * s);
+                if (!f_rot.set)
+                    rot = a;
+            }
+            p->rot = (float)(rot * L_DEG_TO_RAD);
+            if (f_group.set && item.group != p->group)
+            {
+                p->group = item.group;
+                _MoveToColliLinkList(p, (size_t)item.group);
+            }
+            if (f_layer.set && item.layer != p->layer)
+            {
+                _SetObjectLayer(p, item.layer);
+            }
+            _MarkColliGroupDirty(p->group);
+            if (!resources.empty())
+            {
+                Core::ScopeObject<IResourceBase>& res = resources[resources.size() == 1 ? 0 : (size_t)i];
+                if (res && p->ChangeResource(*res))
+                    p->ChangeLuaRC(L, obj_idx);
+            }
+
+        #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+            if (!p->luaclass.IsDefaultCreate)
+            {
+        #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+                // 调用 init，参数与 New 相同，为对象和 params 之后的参数
+                lua_rawgeti(L, 1, LGOBJ_CC_INIT);						// ... ot objects object init
+                lua_pushvalue(L, obj_idx);								// ... ot objects object init object
+                for (int arg = 4; arg <= args_top; arg += 1)
+                    lua_pushvalue(L, arg);								// ... ot objects object init object args...
+                lua_call(L, 1 + nargs, 0);								// ... ot objects object
+        #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+            }
+        #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+
+            lua_rawseti(L, ret_idx, (int)i + 1);						// ... ot objects
+        }
+
+        return 1;
+    }
+    GameObject* GameObjectPool::_PushNewObject(lua_State* L, int class_idx, int ot_idx)
+    {
+        GameObject* p = _AllocObject();
+        if (p == nullptr)
+        {
+            return nullptr;
+        }
+        _PushObjectTable(L, p, class_idx, ot_idx);
+        return p;
+    }
+    void GameObjectPool::_PushObjectTable(lua_State* L, GameObject* p, int class_idx, int ot_idx)
+    {
+        _NewObjectTable(L, ot_idx);									// ... object
+        lua_pushvalue(L, class_idx);								// ... object class
+        lua_rawseti(L, -2, 1);										// ... object
+        lua_pushinteger(L, (lua_Integer)p->id);						// ... object id
+        lua_rawseti(L, -2, 2);										// ... object
+        lua_pushlightuserdata(L, p);								// ... object pGameObject
+        lua_rawseti(L, -2, 3);										// ... object
+        lua_pushinteger(L, (lua_Integer)p->uid);					// ... object uid
+        lua_rawseti(L, -2, LOBJPOOL_OBJECT_UID_IDX);				// ... object
+        lua_rawgeti(L, ot_idx, LOBJPOOL_METATABLE_IDX);				// ... object mt
+        lua_setmetatable(L, -2);									// ... object
+        lua_pushvalue(L, -1);										// ... object object
+        lua_rawseti(L, ot_idx, (int)p->id + 1);						// ... object
+    }
+    GameObject* GameObjectPool::_FindObject(size_t id, uint64_t uid) noexcept
+    {
+        GameObject* p = m_ObjectPool.object(id);
+        if (p && p->uid == uid && p->status == GameObjectStatus::Active)
+            return p;
+        return nullptr;
+    }
+
+    void GameObjectPool::_UpdateEmitters(int ot_idx, lua_Integer superpause)
+    {
+        if (m_Emitters.empty())
+            return;
+        ZoneScopedN("LOBJMGR.ObjFrame.Emitter");
+
+        lua_State* L = G_L;
+        lua_rawgeti(L, ot_idx, LOBJPOOL_EMITTER_IDX);					// ??? et
+        int const et_idx = lua_gettop(L);
+        std::vector<GameObjectEmitter::Shot> shots;
+        shots.swap(m_EmitterShotsCache);
+
+        // init 回调中可能创建或删除发射器，只处理这一帧开始时已有的发射器，并且在调用 lua 代码后不再使用发射器和附着对象的引用；
+        // init 回调中调用 ResetPool 会清空发射器列表，此时立即停止
+        uint64_t const generation = m_EmitterGeneration;
+        size_t const n = m_Emitters.size();
+        for (size_t i = 0; i < n && generation == m_EmitterGeneration; i += 1)
+        {
+            GameObjectEmitter& e = m_Emitters[i];
+            if (e.dead || !e.active)
+                continue;
+            GameObject* owner = nullptr;
+            if (e.has_owner)
+            {
+                owner = _FindObject(e.owner_id, e.owner_uid);
+                if (!owner)
+                {
+                    e.dead = true;
+                    continue;
+                }
+            }
+            if (superpause > 0 && !(owner && owner->ignore_superpause))
+                continue;
+            if (!e.Step())
+            {
+                e.dead = e.IsFinished();
+                continue;
+            }
+
+            // 计算这一次发射的子弹
+            float const ox = owner ? (owner->x + e.x) : e.x;
+            float const oy = owner ? (owner->y + e.y) : e.y;
+            float base_angle = e.GetVolleyAngle();
+            if (e.has_target)
+            {
+                if (GameObject* target = _FindObject(e.target_id, e.target_uid))
+                    base_angle += (float)(std::atan2(target->y - oy, target->x - ox) * L_RAD_TO_DEG);
+            }
+            e.MakeVolley(base_angle, shots);
+            e.dead = e.IsFinished();
+            Core::ScopeObject<IResourceBase> res = e.res;
+        #ifdef USING_MULTI_GAME_WORLD
+            lua_Integer const owner_world = owner ? owner->world : 0;
+        #endif // USING_MULTI_GAME_WORLD
+            lua_Integer const group = e.group;
+            lua_Number const layer = e.layer;
+            bool const has_layer = e.has_layer;
+            float const accel = e.accel;
+            uint32_t const motion = e.motion;
+
+            lua_pushinteger(L, (lua_Integer)e.id);						// ??? et id
+            lua_rawget(L, et_idx);										// ??? et class
+            int const class_idx = lua_gettop(L);
+        #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+            GameObjectClass luaclass;
+            _ResolveClass(L, class_idx, ot_idx, luaclass);
+        #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+            for (auto const& shot : shots)
+            {
+                if (generation != m_EmitterGeneration)
+                    break;
+                GameObject* p = _PushNewObject(L, class_idx, ot_idx);	// ??? et class object
+                if (p == nullptr)
+                {
+                    // 对象池已满，放弃这一次发射剩下的子弹
+                    break;
+                }
+            #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+                p->luaclass = luaclass;
+            #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+            #ifdef USING_MULTI_GAME_WORLD
+                if (owner)
+                    p->world = owner_world;
+            #endif // USING_MULTI_GAME_WORLD
+                float const c = std::cos(shot.angle * (float)L_DEG_TO_RAD);
+                float const s = std::sin(shot.angle * (float)L_DEG_TO_RAD);
+                p->x = ox;
+                p->y = oy;
+                p->vx = shot.speed * c;
+                p->vy = shot.speed * s;
+                p->ax = accel * c;
+                p->ay = accel * s;
+                p->rot = shot.angle * (float)L_DEG_TO_RAD;
+                if (motion != 0)
+                    SetMotion(p, motion);
+                if (group != p->group)
+                {
+                    p->group = group;
+                    _MoveToColliLinkList(p, (size_t)group);
+                }
+                if (has_layer && layer != p->layer)
+                    _SetObjectLayer(p, layer);
+                _MarkColliGroupDirty(p->group);
+                if (res && p->ChangeResource(*res))
+                {
+                    p->ChangeLuaRC(L, lua_gettop(L));
+                }
+            #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+                if (!p->luaclass.IsDefaultCreate)
+                {
+            #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+                    // 调用 init，参数只有对象
+                    lua_rawgeti(L, class_idx, LGOBJ_CC_INIT);			// ??? et class object init
+                    lua_insert(L, -2);									// ??? et class init object
+                    lua_call(L, 1, 0);									// ??? et class
+            #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+                }
+                else
+                {
+                    lua_pop(L, 1);										// ??? et class
+                }
+            #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+            }
+            lua_pop(L, 1);												// ??? et
+        }
+
+        // 移除已经结束的发射器，发射器列表已被替换时 et 是旧的表，新的列表中没有需要移除的发射器
+        if (generation == m_EmitterGeneration)
+        {
+            for (auto const& e : m_Emitters)
+            {
+                if (e.dead)
+                {
+                    lua_pushinteger(L, (lua_Integer)e.id);				// ??? et id
+                    lua_pushnil(L);										// ??? et id nil
+                    lua_rawset(L, et_idx);								// ??? et
+                }
+            }
+            std::erase_if(m_Emitters, [](GameObjectEmitter const& e) { return e.dead; });
+        }
+
+        lua_pop(L, 1);													// ???
+        shots.clear();
+        shots.swap(m_EmitterShotsCache);
+    }
+    int GameObjectPool::NewEmitter(lua_State* L)
+    {
+        luaL_checktype(L, 1, LUA_TTABLE);
+        lua_settop(L, 1);												// desc
+
+        GameObjectEmitter e;
+        auto const opt_number = [L](char const* name, lua_Number def) -> lua_Number
+        {
+            lua_getfield(L, 1, name);									// desc v
+            lua_Number const v = luaL_optnumber(L, -1, def);
+            lua_pop(L, 1);												// desc
+            return v;
+        };
+        // 整数字段先检查范围再转换，NaN 和超出范围的值都不能直接转换成整数
+        auto const opt_integer = [L](char const* name, lua_Integer def, lua_Integer min_v, lua_Integer max_v) -> lua_Integer
+        {
+            lua_getfield(L, 1, name);									// desc v
+            lua_Number const v = luaL_optnumber(L, -1, (lua_Number)def);
+            lua_pop(L, 1);												// desc
+            if (!std::isfinite(v) || v < (lua_Number)min_v || v > (lua_Number)max_v)
+                return luaL_error(L, "invalid field '%s', required %lld <= %s <= %lld.", name, (long long)min_v, name, (long long)max_v);
+            return (lua_Integer)v;
+        };
+
+        lua_getfield(L, 1, "class");									// desc class
+        if (!GameObjectClass::CheckClassValid(L, 2))
+        {
+            return luaL_error(L, "invalid field 'class', luastg object class required for 'NewEmitter'.");
+        }
+        lua_getfield(L, 1, "owner");									// desc class owner
+        if (!lua_isnil(L, -1))
+        {
+            GameObject* owner = _ToGameObject(L, -1);
+            if (owner->status != GameObjectStatus::Active)
+                return luaL_error(L, "invalid field 'owner', object is not active.");
+            e.has_owner = true;
+            e.owner_id = owner->id;
+            e.owner_uid = owner->uid;
+        }
+        lua_getfield(L, 1, "aim");										// desc class owner aim
+        if (!lua_isnil(L, -1))
+        {
+            GameObject* target = _ToGameObject(L, -1);
+            e.has_target = true;
+            e.target_id = target->id;
+            e.target_uid = target->uid;
+        }
+        lua_getfield(L, 1, "img");										// desc class owner aim img
+        if (!lua_isnil(L, -1))
+        {
+            e.img = luaL_check_string_view(L, -1);
+            e.res = GameObject::FindResource(e.img);
+            if (!e.res)
+                return luaL_error(L, "invalid field 'img', can't find resource '%s' in image/animation/particle pool.", e.img.c_str());
+        }
+        lua_getfield(L, 1, "active");									// desc class owner aim img active
+        e.active = lua_isnil(L, -1) || lua_toboolean(L, -1);
+        lua_pop(L, 4);													// desc class
+
+        e.x = (float)opt_number("x", 0.0);
+        e.y = (float)opt_number("y", 0.0);
+        e.group = opt_integer("group", 0, 0, LOBJPOOL_GROUPN - 1);
+        lua_getfield(L, 1, "layer");									// desc class layer
+        if (!lua_isnil(L, -1))
+        {
+            e.layer = luaL_checknumber(L, -1);
+            e.has_layer = true;
+        }
+        lua_pop(L, 1);													// desc class
+        e.motion = (uint32_t)opt_integer("motion", 0, 0, (lua_Integer)m_Motions.size());
+        if (e.motion != 0 && !_IsMotionValid(e.motion))
+            return luaL_error(L, "invalid field 'motion', motion program %lld has been released.", (long long)e.motion);
+        e.count = (uint32_t)opt_integer("count", 1, 0, (lua_Integer)m_ObjectPool.max_size());
+        e.angle = (float)opt_number("angle", 0.0);
+        e.spread = (float)opt_number("spread", 0.0);
+        e.angle_step = (float)opt_number("angle_step", 0.0);
+        e.speed = (float)opt_number("speed", 1.0);
+        e.speed_step = (float)opt_number("speed_step", 0.0);
+        e.accel = (float)opt_number("accel", 0.0);
+        e.random_angle = (float)opt_number("random_angle", 0.0);
+        e.random_speed = (float)opt_number("random_speed", 0.0);
+        e.delay = (int32_t)std::max<lua_Integer>(opt_integer("delay", 0, INT32_MIN, INT32_MAX), 0);
+        e.interval = (int32_t)std::max<lua_Integer>(opt_integer("interval", 1, INT32_MIN, INT32_MAX), 1);
+        e.shots = (int32_t)std::max<lua_Integer>(opt_integer("shots", 0, INT32_MIN, INT32_MAX), 0);
+
+        // 默认种子为发射器序号，创建顺序相同时结果相同
+        m_EmitterId += 1;
+        e.id = m_EmitterId;
+        lua_getfield(L, 1, "seed");										// desc class seed
+        e.random.seed(lua_isnil(L, -1) ? e.id : (uint64_t)luaL_checkinteger(L, -1));
+        lua_pop(L, 1);													// desc class
+
+        // 保存子弹类
+        GetObjectTable(L);												// desc class ot
+        lua_rawgeti(L, -1, LOBJPOOL_EMITTER_IDX);						// desc class ot et
+        lua_pushinteger(L, (lua_Integer)e.id);							// desc class ot et id
+        lua_pushvalue(L, 2);											// desc class ot et id class
+        lua_rawset(L, -3);												// desc class ot et
+        lua_pop(L, 2);													// desc class
+
+        m_Emitters.push_back(std::move(e));
+        lua_pushinteger(L, (lua_Integer)m_EmitterId);
+        return 1;
+    }
+    GameObjectEmitter* GameObjectPool::_FindEmitter(uint64_t id) noexcept
+    {
+        // 序号递增，发射器按创建顺序保存
+        auto it = std::lower_bound(m_Emitters.begin(), m_Emitters.end(), id, [](GameObjectEmitter const& e, uint64_t v) { return e.id < v; });
+        if (it != m_Emitters.end() && it->id == id && !it->dead)
+            return &(*it);
+        return nullptr;
+    }
+    bool GameObjectPool::DelEmitter(lua_State* L, uint64_t id)
+    {
+        GameObjectEmitter* e = _FindEmitter(id);
+        if (!e)
+            return false;
+        // 只做标记，发射器在下一次更新时移除，更新过程中删除也是安全的
+        e->dead = true;
+        GetObjectTable(L);						// ??? ot
+        lua_rawgeti(L, -1, LOBJPOOL_EMITTER_IDX);	// ??? ot et
+        lua_pushinteger(L, (lua_Integer)id);	// ??? ot et id
+        lua_pushnil(L);							// ??? ot et id nil
+        lua_rawset(L, -3);						// ??? ot et
+        lua_pop(L, 2);							// ???
+        return true;
+    }
+    bool GameObjectPool::SetEmitterActive(uint64_t id, bool active) noexcept
+    {
+        GameObjectEmitter* e = _FindEmitter(id);
+        if (!e)
+            return false;
+        e->active = active;
+        return true;
+    }
+    bool GameObjectPool::SetEmitterPosition(uint64_t id, float x, float y) noexcept
+    {
+        GameObjectEmitter* e = _FindEmitter(id);
+        if (!e)
+            return false;
+        e->x = x;
+        e->y = y;
+        return true;
+    }
+    struct GameObjectPool::_MotionTargetFinder : public GameObjectMotion::ITargetFinder
+    {
+        GameObjectPool* pool;
+        explicit _MotionTargetFinder(GameObjectPool* p) : pool(p) {}
+        bool FindTarget(GameObject const* self, lua_Integer group, float& x, float& y) override
+        {
+            return pool->_FindNearestInGroup(self, group, x, y);
+        }
+    };
+    bool GameObjectPool::_UpdateMotion(GameObject* p, int ot_idx, int cc_idx)
+    {
+    #ifdef LUASTG_ENABLE_GAME_OBJECT_PROPERTY_PAUSE
+        if (p->pause > 0)
+            return true; // 暂停期间运动程序也暂停
+    #endif
+        if (!_IsMotionValid(p->motion))
+        {
+            p->motion = 0;
+            return true;
+        }
+        _MotionTargetFinder finder(this);
+        switch (m_Motions[p->motion - 1].Step(p, finder))
+        {
+        case GameObjectMotion::Result::Finished:
+            p->motion = 0;
+            return true;
+        case GameObjectMotion::Result::Delete:
+            p->motion = 0;
+            // 和越界一样设置为 del 状态
+            _MarkColliGroupDirty(p->group);
+            p->status = GameObjectStatus::Dead;
+        #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+            if (!p->luaclass.IsDefaultDestroy)
+            {
+        #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+                _GameObjectCallback(G_L, ot_idx, cc_idx, p, LGOBJ_CC_DEL);
+        #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+            }
+        #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+            return false;
+        default:
+            return true;
+        }
+    }
+    bool GameObjectPool::_FindNearestInGroup(GameObject const* self, lua_Integer group, float& x, float& y)
+    {
+        bool const valid_group = 0 <= group && group < LOBJPOOL_GROUPN;
+        GameObjectMotion::TargetSet& targets = m_MotionTargets[valid_group ? (size_t)group : LOBJPOOL_GROUPN];
+        if (!targets.IsBuilt())
+        {
+            ZoneScopedN("LOBJMGR.ObjFrame.MotionTarget");
+            if (valid_group)
+            {
+                for (GameObject* p = m_ColliLinkList[(size_t)group].first.pColliNext; p != &m_ColliLinkList[(size_t)group].second; p = p->pColliNext)
+                {
+                    if (p->status == GameObjectStatus::Active)
+                        targets.Add(p);
+                }
+            }
+            else
+            {
+                for (GameObject* p = m_UpdateLinkList.first.pUpdateNext; p != &m_UpdateLinkList.second; p = p->pUpdateNext)
+                {
+                    if (p->status == GameObjectStatus::Active)
+                        targets.Add(p);
+                }
+            }
+            targets.Build();
+        }
+        auto const* nearest = targets.FindNearest(self->x, self->y, [&](GameObjectMotion::TargetSet::Target const& t) -> bool
+        {
+            if (t.object == self)
+                return false;
+        #ifdef USING_MULTI_GAME_WORLD
+            if (!CheckWorlds(t.world, self->world))
+                return false;
+        #endif // USING_MULTI_GAME_WORLD
+            return true;
+        });
+        if (!nearest)
+            return false;
+        x = nearest->x;
+        y = nearest->y;
+        return true;
+    }
+    int GameObjectPool::NewMotion(lua_State* L)
+    {
+        static std::pair<std::string_view, GameObjectMotion::Op> const op_names[] = {
+            { "speed", GameObjectMotion::Op::Speed },
+            { "accel", GameObjectMotion::Op::Accel },
+            { "angle", GameObjectMotion::Op::Angle },
+            { "turn", GameObjectMotion::Op::Turn },
+            { "aim", GameObjectMotion::Op::Aim },
+            { "home", GameObjectMotion::Op::Home },
+            { "del", GameObjectMotion::Op::Del },
+        };
+
+        luaL_checktype(L, 1, LUA_TTABLE);
+        int const n = (int)lua_objlen(L, 1);
+        if (n <= 0)
+        {
+            return luaL_error(L, "motion program requires at least one segment.");
+        }
+        GameObjectMotion motion;
+        for (int i = 1; i <= n; i += 1)
+        {
+            lua_rawgeti(L, 1, i);										// ... seg
+            if (!lua_istable(L, -1))
+            {
+                return luaL_error(L, "invalid motion segment #%d, table required.", i);
+            }
+            int const seg_idx = lua_gettop(L);
+            auto const opt_number = [L, seg_idx](char const* name, lua_Number def) -> lua_Number
+            {
+                lua_getfield(L, seg_idx, name);							// ... seg v
+                lua_Number const v = luaL_optnumber(L, -1, def);
+                lua_pop(L, 1);											// ... seg
+                return v;
+            };
+            auto const opt_integer = [L, seg_idx, i](char const* name, lua_Integer def, lua_Integer min_v, lua_Integer max_v) -> lua_Integer
+            {
+                lua_getfield(L, seg_idx, name);							// ... seg v
+                lua_Number const v = luaL_optnumber(L, -1, (lua_Number)def);
+                lua_pop(L, 1);											// ... seg
+                if (!std::isfinite(v) || v < (lua_Number)min_v || v > (lua_Number)max_v)
+                    return luaL_error(L, "invalid motion segment #%d, required %lld <= %s <= %lld.", i, (long long)min_v, name, (long long)max_v);
+                return (lua_Integer)v;
+            };
+            GameObjectMotion::Segment seg;
+            lua_getfield(L, seg_idx, "op");								// ... seg op
+            std::string_view const op = luaL_check_string_view(L, -1);
+            auto const it = std::find_if(std::begin(op_names), std::end(op_names), [&](auto const& v) { return v.first == op; });
+            if (it == std::end(op_names))
+            {
+                return luaL_error(L, "invalid motion segment #%d, unknown op '%s'.", i, lua_tostring(L, -1));
+            }
+            lua_pop(L, 1);												// ... seg
+            seg.op = it->second;
+            lua_Number const at = opt_number("at", 0.0);
+            lua_Number const time = opt_number("time", 0.0);
+            if (!(at >= 0.0 && at <= (lua_Number)INT32_MAX / 2) || !(time >= 0.0 && time <= (lua_Number)INT32_MAX / 2))
+            {
+                return luaL_error(L, "invalid motion segment #%d, 'at' and 'time' must be non-negative frame counts.", i);
+            }
+            seg.start = (int32_t)at;
+            seg.duration = (int32_t)time;
+            seg.value = (float)opt_number("value", 0.0);
+            seg.group = opt_integer("group", 0, 0, LOBJPOOL_GROUPN - 1);
+            motion.AddSegment(seg);
+            lua_pop(L, 1);												// ...
+        }
+
+        uint32_t const id = _InternMotion(std::move(motion));
+        m_MotionRefs[id - 1] += 1;
+        lua_pushinteger(L, (lua_Integer)id);
+        return 1;
+    }
+    uint32_t GameObjectPool::_InternMotion(GameObjectMotion&& motion)
+    {
+        // 相同的程序只保存一份，重复创建时不会增加内存占用
+        size_t const hash = motion.GetHash();
+        auto const range = m_MotionIndex.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (m_Motions[it->second - 1].GetSegments() == motion.GetSegments())
+                return it->second;
+        }
+        if (m_MotionFree.empty() && m_MotionCollect)
+            _CollectMotions();
+        uint32_t id = 0;
+        if (!m_MotionFree.empty())
+        {
+            id = m_MotionFree.back();
+            m_MotionFree.pop_back();
+            m_Motions[id - 1] = std::move(motion);
+            m_MotionRefs[id - 1] = 0;
+        }
+        else
+        {
+            m_Motions.push_back(std::move(motion));
+            m_MotionRefs.push_back(0);
+            id = (uint32_t)m_Motions.size();
+        }
+        m_MotionIndex.emplace(hash, id);
+        return id;
+    }
+    void GameObjectPool::_CollectMotions()
+    {
+        m_MotionCollect = false;
+        std::vector<bool> used(m_Motions.size(), false);
+        for (GameObject* p = m_UpdateLinkList.first.pUpdateNext; p != &m_UpdateLinkList.second; p = p->pUpdateNext)
+        {
+            if (p->motion != 0 && p->motion <= m_Motions.size())
+                used[p->motion - 1] = true;
+        }
+        // 已结束的发射器在这一次发射完成后才移除，仍然可能使用运动程序
+        for (auto const& e : m_Emitters)
+        {
+            if (e.motion != 0 && e.motion <= m_Motions.size())
+                used[e.motion - 1] = true;
+        }
+        for (size_t i = 0; i < m_Motions.size(); i += 1)
+        {
+            if (m_MotionRefs[i] != 0 || m_Motions[i].IsEmpty())
+                continue;
+            if (used[i])
+            {
+                m_MotionCollect = true; // 还在使用，下次再检查
+                continue;
+            }
+            uint32_t const id = (uint32_t)i + 1;
+            auto const range = m_MotionIndex.equal_range(m_Motions[i].GetHash());
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                if (it->second == id)
+                {
+                    m_MotionIndex.erase(it);
+                    break;
+                }
+            }
+            m_Motions[i] = GameObjectMotion();
+            m_MotionFree.push_back(id);
+        }
+    }
+    bool GameObjectPool::DelMotion(uint32_t motion) noexcept
+    {
+        if (!_IsMotionValid(motion) || m_MotionRefs[motion - 1] == 0)
+            return false;
+        m_MotionRefs[motion - 1] -= 1;
+        if (m_MotionRefs[motion - 1] == 0)
+            m_MotionCollect = true;
+        return true;
+    }
+    bool GameObjectPool::SetMotion(GameObject* p, uint32_t motion) noexcept
+    {
+        if (motion != 0 && !_IsMotionValid(motion))
+            return false;
+        p->motion = motion;
+        p->motion_timer = 0;
+        if (std::abs(p->vx) > std::numeric_limits<float>::min() || std::abs(p->vy) > std::numeric_limits<float>::min())
+            p->motion_angle = (float)(std::atan2(p->vy, p->vx) * L_RAD_TO_DEG);
+        else
+            p->motion_angle = (float)(p->rot * L_RAD_TO_DEG);
+        return true;
+    }
+    static constexpr uint32_t SNAPSHOT_MAGIC = 0x534f4c4c; // "LLOS"
+    static constexpr uint32_t SNAPSHOT_VERSION = 2;
+    static bool _IsMotionSegmentValid(GameObjectMotion::Segment const& seg) noexcept
+    {
+        return seg.op >= GameObjectMotion::Op::Speed && seg.op <= GameObjectMotion::Op::Del
+            && seg.start >= 0 && seg.start <= INT32_MAX / 2
+            && seg.duration >= 0 && seg.duration <= INT32_MAX / 2
+            && seg.group >= 0 && seg.group < LOBJPOOL_GROUPN;
+    }
+    // 对象按结构体整体读取，枚举字段在读取后检查取值范围；位域的任何取值都有效
+    static bool _IsSnapshotObjectValid(GameObject const& o) noexcept
+    {
+        if (o.status != GameObjectStatus::Active && o.status != GameObjectStatus::Dead && o.status != GameObjectStatus::Killed)
+            return false;
+    #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+        if (o.blendmode < BlendMode::MulAlpha || o.blendmode > BlendMode::HueScreen)
+            return false;
+    #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+        return o.group >= 0 && o.group < LOBJPOOL_GROUPN;
+    }
+    int GameObjectPool::Snapshot(lua_State* L)
+    {
+        if (m_pCurrentObject || m_IsRendering || m_LockObjectA || m_LockObjectB || m_IterationDepth > 0)
+        {
+            return luaL_error(L, "illegal operation, snapshot can not be taken in object callbacks, 'lstg.ObjFrame', 'lstg.ObjRender', 'lstg.BoundCheck', 'lstg.CollisionCheck' or 'lstg.ForEachInGroup'.");
+        }
+        bool const has_hook = !lua_isnoneornil(L, 1);
+        if (has_hook)
+        {
+            luaL_checktype(L, 1, LUA_TFUNCTION);
+        }
+        lua_settop(L, 1);
+        ZoneScopedN("LOBJMGR.Snapshot");
+
+        // 原生部分
+
+        std::vector<GameObject*> objects;
+        objects.reserve(m_ObjectPool.size());
+        for (GameObject* p = m_UpdateLinkList.first.pUpdateNext; p != &m_UpdateLinkList.second; p = p->pUpdateNext)
+            objects.push_back(p);
+
+        std::string data;
+        GameObjectSnapshotWriter w(data);
+        w.Write(SNAPSHOT_MAGIC);
+        w.Write(SNAPSHOT_VERSION);
+        w.Write((uint32_t)sizeof(GameObject));
+        w.Write(m_iUid);
+        w.Write(m_superpause);
+        w.Write(m_nextsuperpause);
+        w.Write(m_iWorld);
+        w.Write(m_Worlds);
+        w.Write(m_BoundLeft);
+        w.Write(m_BoundRight);
+        w.Write(m_BoundBottom);
+        w.Write(m_BoundTop);
+        w.Write(m_EmitterId);
+        w.Write((uint32_t)objects.size());
+        std::string ps_state;
+        for (GameObject* p : objects)
+        {
+            // 指针在恢复时重新设置，资源按名称重新查找
+            w.Write(*p);
+            w.WriteString(p->res ? p->res->GetResName() : std::string_view());
+            w.Write(p->ps != nullptr);
+            if (p->ps)
+            {
+                ps_state.clear();
+                p->ps->SaveState(ps_state);
+                w.WriteString(ps_state);
+            }
+        }
+        for (size_t group = 0; group < LOBJPOOL_GROUPN; group += 1)
+        {
+            uint32_t count = 0;
+            for (GameObject* p = m_ColliLinkList[group].first.pColliNext; p != &m_ColliLinkList[group].second; p = p->pColliNext)
+                count += 1;
+            w.Write(count);
+            for (GameObject* p = m_ColliLinkList[group].first.pColliNext; p != &m_ColliLinkList[group].second; p = p->pColliNext)
+                w.Write(p->id);
+        }
+        w.Write((uint32_t)m_Emitters.size());
+        for (auto& e : m_Emitters)
+            e.Save(w);
+        // 运动程序在恢复之前可能已经回收，序号也可能被复用，保存用到的程序，恢复时按内容重新查找或加入
+        std::vector<uint32_t> motions;
+        std::vector<bool> motion_saved(m_Motions.size(), false);
+        auto const save_motion = [&](uint32_t motion)
+        {
+            if (_IsMotionValid(motion) && !motion_saved[motion - 1])
             {
-        #endif // USING_MULTI_GAME_WORLD
-                if (!_ObjectBoundCheck(p))
-                {
-                    m_pCurrentObject = p;
-                    // 越界设置为 del 状态
-                    p->status = GameObjectStatus::Dead;
-                    // 调用 del callback
-                #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
-                    if (!p->luaclass.IsDefaultDestroy)
-                    {
-                #endif // USING_ADVANCE_GAMEOBJECT_CLASS
-                        _GameObjectCallback(G_L, ot_idx, p, LGOBJ_CC_DEL);
-                #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
-                    }
-                #endif // USING_ADVANCE_GAMEOBJECT_CLASS
-                }
-        #ifdef USING_MULTI_GAME_WORLD
+                motion_saved[motion - 1] = true;
+                motions.push_back(motion);
             }
-        #endif // USING_MULTI_GAME_WORLD
+        };
+        for (GameObject* p : objects)
+            save_motion(p->motion);
+        for (auto const& e : m_Emitters)
+            save_motion(e.motion);
+        w.Write((uint32_t)motions.size());
+        for (uint32_t const motion : motions)
+        {
+            auto const& segments = m_Motions[motion - 1].GetSegments();
+            w.Write(motion);
+            w.Write((uint32_t)segments.size());
+            for (auto const& seg : segments)
+                w.Write(seg);
         }
-        m_pCurrentObject = nullptr;
 
-        lua_pop(G_L, 1);
+        // lua 部分，对象类和发射器的子弹类保存为引用，钩子函数的返回值按对象顺序保存
+
+        lua_createtable(L, 0, 4);										// hook snap
+        int const snap_idx = lua_gettop(L);
+        lua_pushlstring(L, data.data(), data.size());					// hook snap data
+        lua_setfield(L, snap_idx, "data");								// hook snap
+        GetObjectTable(L);												// hook snap ot
+        int const ot_idx = lua_gettop(L);
+        lua_createtable(L, (int)objects.size(), 0);						// hook snap ot classes
+        int const classes_idx = lua_gettop(L);
+        lua_createtable(L, has_hook ? (int)objects.size() : 0, 0);		// hook snap ot classes values
+        int const values_idx = lua_gettop(L);
+        for (size_t i = 0; i < objects.size(); i += 1)
+        {
+            lua_rawgeti(L, ot_idx, (int)objects[i]->id + 1);			// ... object
+            lua_rawgeti(L, -1, 1);										// ... object class
+            lua_rawseti(L, classes_idx, (int)i + 1);					// ... object
+            if (has_hook)
+            {
+                lua_pushvalue(L, 1);									// ... object hook
+                lua_insert(L, -2);										// ... hook object
+                lua_call(L, 1, 1);										// ... value
+                lua_rawseti(L, values_idx, (int)i + 1);					// ...
+            }
+            else
+            {
+                lua_pop(L, 1);											// ...
+            }
+        }
+        lua_setfield(L, snap_idx, "values");							// hook snap ot classes
+        lua_setfield(L, snap_idx, "classes");							// hook snap ot
+        lua_rawgeti(L, ot_idx, LOBJPOOL_EMITTER_IDX);					// hook snap ot et
+        lua_createtable(L, (int)m_Emitters.size(), 0);					// hook snap ot et emitters
+        for (size_t i = 0; i < m_Emitters.size(); i += 1)
+        {
+            lua_pushinteger(L, (lua_Integer)m_Emitters[i].id);			// ... et emitters id
+            lua_rawget(L, -3);											// ... et emitters class
+            lua_rawseti(L, -2, (int)i + 1);								// ... et emitters
+        }
+        lua_setfield(L, snap_idx, "emitters");							// hook snap ot et
+        lua_settop(L, snap_idx);										// hook snap
+        return 1;
     }
-    void GameObjectPool::CollisionCheck(size_t groupA, size_t groupB)
+    int GameObjectPool::Restore(lua_State* L)
     {
-        ZoneScopedN("LOBJMGR.CollisionCheck");
-
-        if (groupA < 0 || groupA >= LOBJPOOL_SIZE || groupB < 0 || groupB >= LOBJPOOL_SIZE)
-            luaL_error(G_L, "Invalid collision group.");
-
-        GetObjectTable(G_L); // ot
-
-        m_pCurrentObject = nullptr;
-        for (GameObject* ptrA = m_ColliLinkList[groupA].first.pColliNext; ptrA != &m_ColliLinkList[groupA].second;)
+        if (m_pCurrentObject || m_IsRendering || m_LockObjectA || m_LockObjectB || m_IterationDepth > 0)
         {
-            GameObject* pA = ptrA;
-            ptrA = ptrA->pColliNext;
+            return luaL_error(L, "illegal operation, snapshot can not be restored in object callbacks, 'lstg.ObjFrame', 'lstg.ObjRender', 'lstg.BoundCheck', 'lstg.CollisionCheck' or 'lstg.ForEachInGroup'.");
+        }
+        luaL_checktype(L, 1, LUA_TTABLE);
+        bool const has_hook = !lua_isnoneornil(L, 2);
+        if (has_hook)
+        {
+            luaL_checktype(L, 2, LUA_TFUNCTION);
+        }
+        lua_settop(L, 2);												// snap hook
+        lua_getfield(L, 1, "data");										// snap hook data
+        lua_getfield(L, 1, "classes");									// snap hook data classes
+        lua_getfield(L, 1, "values");									// snap hook data classes values
+        lua_getfield(L, 1, "emitters");									// snap hook data classes values emitters
+        int const classes_idx = 4;
+        int const values_idx = 5;
+        int const emitters_idx = 6;
+        size_t size = 0;
+        char const* data = lua_tolstring(L, 3, &size);
+        if (!data || !lua_istable(L, classes_idx) || !lua_istable(L, emitters_idx))
+        {
+            return luaL_error(L, "invalid object pool snapshot.");
+        }
+        ZoneScopedN("LOBJMGR.Restore");
 
-            m_LockObjectA = ptrA;
+        // 先完整解析，数据无效时不修改对象池
 
-            for (GameObject* ptrB = m_ColliLinkList[groupB].first.pColliNext; ptrB != &m_ColliLinkList[groupB].second;)
+        struct Record
+        {
+            GameObject object;
+            std::string res;
+            bool has_ps{ false };
+            std::string ps_state;
+        };
+        GameObjectSnapshotReader r(std::string_view(data, size));
+        uint32_t magic = 0, version = 0, object_size = 0;
+        if (!r.Read(magic) || !r.Read(version) || !r.Read(object_size)
+            || magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION || object_size != sizeof(GameObject))
+        {
+            return luaL_error(L, "invalid object pool snapshot, incompatible header.");
+        }
+        uint64_t uid = 0;
+        lua_Integer superpause = 0, nextsuperpause = 0, world = 0;
+        std::array<lua_Integer, 4> worlds{};
+        lua_Number bound_l = 0, bound_r = 0, bound_b = 0, bound_t = 0;
+        uint64_t emitter_id = 0;
+        uint32_t object_count = 0;
+        bool ok = r.Read(uid) && r.Read(superpause) && r.Read(nextsuperpause) && r.Read(world) && r.Read(worlds)
+            && r.Read(bound_l) && r.Read(bound_r) && r.Read(bound_b) && r.Read(bound_t)
+            && r.Read(emitter_id) && r.Read(object_count) && object_count <= m_ObjectPool.max_size();
+        std::vector<Record> records;
+        size_t max_old_id = 0;
+        if (ok)
+        {
+            records.resize(object_count);
+            for (auto& rec : records)
             {
-                GameObject* pB = ptrB;
-                ptrB = ptrB->pColliNext;
-            #ifdef USING_MULTI_GAME_WORLD
-                if (CheckWorlds(pA->world, pB->world))
-                {
-            #endif // USING_MULTI_GAME_WORLD
-                    m_DbgData[m_DbgIdx].object_colli_check += 1;
-                    if (LuaSTGPlus::CollisionCheck(pA, pB))
-                    {
-                        m_DbgData[m_DbgIdx].object_colli_callback += 1;
-                        m_pCurrentObject = pA;
-
-                        m_LockObjectB = ptrB;
-
-                        // TODO: 是否有必要这样？其实相当于关闭了判定吧？
-                    #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
-                        if (!pA->luaclass.IsDefaultTrigger)
-                        {
-                    #endif // USING_ADVANCE_GAMEOBJECT_CLASS
-                            // 根据id获取对象的lua绑定table、拿到class再拿到collifunc
-                            lua_rawgeti(G_L, -1, pA->id + 1);		// ot t(object)
-                            lua_rawgeti(G_L, -1, 1);				// ot t(object) t(class)
-                            lua_rawgeti(G_L, -1, LGOBJ_CC_COLLI);	// ot t(object) t(class) f(colli)
-                            lua_pushvalue(G_L, -3);					// ot t(object) t(class) f(colli) t(object)
-                            lua_rawgeti(G_L, -5, pB->id + 1);		// ot t(object) t(class) f(colli) t(object) t(object)
-                            lua_call(G_L, 2, 0);					// ot t(object) t(class)
-                            lua_pop(G_L, 2);						// ot
-                    #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
-                        }
-                    #endif // USING_ADVANCE_GAMEOBJECT_CLASS
-
-                        m_LockObjectB = nullptr;
-                    }
-            #ifdef USING_MULTI_GAME_WORLD
-                }
-            #endif // USING_MULTI_GAME_WORLD
+                ok = r.Read(rec.object) && r.ReadString(rec.res) && r.Read(rec.has_ps) && (!rec.has_ps || r.ReadString(rec.ps_state))
+                    && rec.object.id < m_ObjectPool.max_size()
+                    && _IsSnapshotObjectValid(rec.object);
+                if (!ok)
+                    break;
+                max_old_id = std::max(max_old_id, rec.object.id);
             }
-
-            m_LockObjectA = nullptr;
         }
-        m_pCurrentObject = nullptr;
 
-        lua_pop(G_L, 1);
-    }
-    void GameObjectPool::UpdateXY() noexcept
-    {
-        ZoneScopedN("LOBJMGR.UpdateXY");
+        // 碰撞链表必须与对象一一对应：旧序号不重复，每个对象恰好出现一次，且位于自己所在的碰撞组
 
-        int superpause = GetSuperPauseTime();
-        for (GameObject* p = m_UpdateLinkList.first.pUpdateNext; p != &m_UpdateLinkList.second; p = p->pUpdateNext)
+        constexpr uint32_t invalid_record = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t> record_of(records.empty() ? 0 : max_old_id + 1, invalid_record);
+        for (uint32_t i = 0; ok && i < (uint32_t)records.size(); i += 1)
         {
-            if (superpause <= 0 || p->ignore_superpause)
+            uint32_t& slot = record_of[records[i].object.id];
+            ok = slot == invalid_record;
+            slot = i;
+        }
+        std::vector<bool> listed(records.size(), false);
+        std::array<std::vector<size_t>, LOBJPOOL_GROUPN> colli_order;
+        size_t listed_count = 0;
+        for (size_t group = 0; ok && group < LOBJPOOL_GROUPN; group += 1)
+        {
+            uint32_t count = 0;
+            ok = r.Read(count) && count <= object_count - listed_count;
+            for (uint32_t i = 0; ok && i < count; i += 1)
             {
-                p->UpdateLast();
+                size_t id = 0;
+                ok = r.Read(id) && id < record_of.size() && record_of[id] != invalid_record
+                    && !listed[record_of[id]] && records[record_of[id]].object.group == (lua_Integer)group;
+                if (!ok)
+                    break;
+                listed[record_of[id]] = true;
+                colli_order[group].push_back(id);
             }
+            listed_count += count;
+        }
+        ok = ok && listed_count == object_count;
+        std::vector<GameObjectEmitter> emitters;
+        uint32_t emitter_count = 0;
+        ok = ok && r.Read(emitter_count);
+        for (uint32_t i = 0; ok && i < emitter_count; i += 1)
+        {
+            emitters.emplace_back();
+            ok = emitters.back().Load(r)
+                && emitters.back().group >= 0 && emitters.back().group < LOBJPOOL_GROUPN;
+        }
+        std::vector<std::pair<uint32_t, GameObjectMotion>> motions;
+        uint32_t motion_count = 0;
+        ok = ok && r.Read(motion_count);
+        for (uint32_t i = 0; ok && i < motion_count; i += 1)
+        {
+            uint32_t motion = 0, segment_count = 0;
+            ok = r.Read(motion) && r.Read(segment_count) && motion != 0 && segment_count != 0;
+            GameObjectMotion program;
+            for (uint32_t j = 0; ok && j < segment_count; j += 1)
+            {
+                GameObjectMotion::Segment seg;
+                ok = r.Read(seg) && _IsMotionSegmentValid(seg);
+                if (ok)
+                    program.AddSegment(seg);
+            }
+            if (ok)
+                motions.emplace_back(motion, std::move(program));
+        }
+        if (!ok || !r.IsEnd())
+        {
+            return luaL_error(L, "invalid object pool snapshot, data corrupted.");
+        }
+        for (auto& e : emitters)
+        {
+            // 和对象一样，找不到图像时只给出警告
+            if (e.img.empty())
+                continue;
+            e.res = GameObject::FindResource(e.img);
+            if (!e.res)
+                spdlog::warn("[luastg] Restore: 找不到发射器的资源 '{}' (id={})", e.img, e.id);
+        }
+        for (size_t i = 0; i < records.size(); i += 1)
+        {
+            lua_rawgeti(L, classes_idx, (int)i + 1);					// ... class
+            if (!GameObjectClass::CheckClassValid(L, -1))
+            {
+                return luaL_error(L, "invalid object pool snapshot, object class missing.");
+            }
+            lua_pop(L, 1);												// ...
         }
-    }
-    void GameObjectPool::AfterFrame() noexcept
-    {
-        ZoneScopedN("LOBJMGR.AfterFrame");
 
-        GetObjectTable(G_L);
-        int const ot_at = lua_gettop(G_L);
+        // 回收现有对象，不调用回调函数
 
-        int superpause = GetSuperPauseTime();
+        GetObjectTable(L);												// snap hook data classes values emitters ot
+        int const ot_idx = lua_gettop(L);
         for (GameObject* p = m_UpdateLinkList.first.pUpdateNext; p != &m_UpdateLinkList.second;)
         {
-            if (superpause <= 0 || p->ignore_superpause)
+            p = _FreeObject(p, ot_idx);
+        }
+        _ClearLinkList();
+        m_RenderList.Clear();
+        m_ObjectPool.clear();
+        m_pCurrentObject = nullptr;
+        m_ObjectIdGeneration += 1; // 和整理对象池一样，让没有遍历结束的迭代器停止
+
+        // 运动程序按内容重新查找或加入，lua 可能已经不再引用这些程序，之后按需回收
+
+        std::unordered_map<uint32_t, uint32_t> motion_id;
+        for (auto& [motion, program] : motions)
+            motion_id[motion] = _InternMotion(std::move(program));
+        if (!motions.empty())
+            m_MotionCollect = true;
+        auto const remap_motion = [&motion_id](uint32_t motion) -> uint32_t
+        {
+            auto const it = motion_id.find(motion);
+            return it != motion_id.end() ? it->second : 0;
+        };
+
+        // 按原来的更新顺序重建对象，序号从 0 开始重新分配
+
+        constexpr size_t invalid_id = std::numeric_limits<size_t>::max();
+        std::vector<size_t> new_id(records.empty() ? 0 : max_old_id + 1, invalid_id);
+        for (size_t i = 0; i < records.size(); i += 1)
+        {
+            Record const& rec = records[i];
+            size_t id = 0;
+            m_ObjectPool.alloc(id);
+            assert(id == i);
+            GameObject* p = m_ObjectPool.object(id);
+            *p = rec.object;
+            p->res = nullptr;
+            p->ps = nullptr;
+            if (!rec.res.empty())
             {
-                p->UpdateTimer();
-                if (p->status != GameObjectStatus::Active)
+                // 资源会修改碰撞体积等属性，重新查找资源后再恢复其他字段
+                if (p->ChangeResource(rec.res))
                 {
-                    p = _FreeObject(p, ot_at); // 再下一个
+                    IResourceBase* const res = p->res;
+                    IParticlePool* const ps = p->ps;
+                    *p = rec.object;
+                    p->res = res;
+                    p->ps = ps;
+                    if (ps && rec.has_ps && !ps->LoadState(rec.ps_state))
+                        spdlog::warn("[luastg] Restore: 无法恢复粒子池状态 (uid={})", p->uid);
                 }
                 else
                 {
-                    p = p->pUpdateNext;
+                    spdlog::warn("[luastg] Restore: 找不到资源 '{}' (uid={})", rec.res, p->uid);
+                    p->res = nullptr;
+                    p->ps = nullptr;
                 }
             }
-            else
+            p->id = id;
+            p->motion = remap_motion(p->motion);
+            p->pUpdatePrev = p->pUpdateNext = nullptr;
+            p->pColliPrev = p->pColliNext = nullptr;
+            _InsertToUpdateLinkList(p);
+            _InsertToRenderList(p);
+            new_id[rec.object.id] = id;
+
+            lua_rawgeti(L, classes_idx, (int)i + 1);					// ... ot class
+            int const class_idx = lua_gettop(L);
+            _PushObjectTable(L, p, class_idx, ot_idx);					// ... ot class object
+        #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+            _ResolveClass(L, class_idx, ot_idx, p->luaclass);
+        #endif // USING_ADVANCE_GAMEOBJECT_CLASS
+            p->ChangeLuaRC(L, lua_gettop(L));
+            lua_pop(L, 2);												// ... ot
+        }
+        for (size_t group = 0; group < LOBJPOOL_GROUPN; group += 1)
+        {
+            for (size_t const old : colli_order[group])
             {
-                p = p->pUpdateNext;
+                _InsertToColliLinkList(m_ObjectPool.object(new_id[old]), group);
             }
         }
+        m_RenderList.Flush();
+        _MarkAllColliGroupDirty();
+
+        m_iUid = uid;
+        m_superpause = superpause;
+        m_nextsuperpause = nextsuperpause;
+        m_iWorld = world;
+        m_Worlds = worlds;
+        m_BoundLeft = bound_l;
+        m_BoundRight = bound_r;
+        m_BoundBottom = bound_b;
+        m_BoundTop = bound_t;
+
+        // 发射器，附着对象不在快照中时 uid 不会匹配，发射器会在下一次更新时删除
+
+        lua_createtable(L, (int)emitters.size(), 0);					// ... ot et
+        for (size_t i = 0; i < emitters.size(); i += 1)
+        {
+            auto& e = emitters[i];
+            if (e.has_owner)
+                e.owner_id = (e.owner_id < new_id.size() && new_id[e.owner_id] != invalid_id) ? new_id[e.owner_id] : 0;
+            if (e.has_target)
+                e.target_id = (e.target_id < new_id.size() && new_id[e.target_id] != invalid_id) ? new_id[e.target_id] : 0;
+            e.motion = remap_motion(e.motion);
+            lua_pushinteger(L, (lua_Integer)e.id);						// ... ot et id
+            lua_rawgeti(L, emitters_idx, (int)i + 1);					// ... ot et id class
+            lua_rawset(L, -3);											// ... ot et
+        }
+        lua_rawseti(L, ot_idx, LOBJPOOL_EMITTER_IDX);					// ... ot
+        m_Emitters = std::move(emitters);
+        m_EmitterId = emitter_id;
+        m_EmitterGeneration += 1;
 
-        lua_pop(G_L, 1);
-    }
+        // 最后调用钩子函数，此时所有对象都已经存在
 
-    int GameObjectPool::New(lua_State* L)
-    {
-        // 检查参数
-        if (!GameObjectClass::CheckClassValid(L, 1))
+        if (has_hook && lua_istable(L, values_idx))
         {
-            return luaL_error(L, "invalid argument #1, luastg object class required for 'New'.");
+            for (size_t i = 0; i < records.size(); i += 1)
+            {
+                lua_pushvalue(L, 2);									// ... ot hook
+                lua_rawgeti(L, ot_idx, (int)i + 1);						// ... ot hook object
+                lua_rawgeti(L, values_idx, (int)i + 1);					// ... ot hook object value
+                lua_call(L, 2, 0);										// ... ot
+            }
         }
 
-        // 分配一个对象
-        GameObject* p = _AllocObject();
-        if (p == nullptr)
+        lua_pushinteger(L, (lua_Integer)records.size());
+        return 1;
+    }
+    int GameObjectPool::SetAttrs(lua_State* L)
+    {
+        GameObject* p = _ToGameObject(L, 1);
+        luaL_checktype(L, 2, LUA_TTABLE);
+        lua_settop(L, 2);											// object fields
+        _MemberChange c;
+        _BeginSetMember(c, p);
+        // 类决定 _blend、_color 等属性的含义，图片决定碰撞体大小，先设置
+        constexpr std::pair<char const*, LuaSTG::GameObjectMember> first[] = {
+            { "class", LuaSTG::GameObjectMember::CLASS },
+            { "img", LuaSTG::GameObjectMember::IMG },
+        };
+        for (auto const& [name, member] : first)
         {
-            return luaL_error(L, "can't alloc object, object pool may be full.");
+            lua_pushstring(L, name);								// object fields k
+            lua_pushvalue(L, 3);									// object fields k k
+            lua_rawget(L, 2);										// object fields k v
+            if (!lua_isnil(L, 4))
+                _SetMember(L, c, member, 3, 4);
+            lua_settop(L, 2);										// object fields
         }
-
-    #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
-        p->luaclass.CheckClassClass(L, 1);
-    #endif // USING_ADVANCE_GAMEOBJECT_CLASS
-
-        //											// class ...
-
-        // 创建对象 table
-        GetObjectTable(L);							// class ... ot
-        lua_createtable(L, 3, 0);					// class ... ot object
-        lua_pushvalue(L, 1);						// class ... ot object class
-        lua_rawseti(L, -2, 1);						// class ... ot object
-        lua_pushinteger(L, (lua_Integer)p->id);		// class ... ot object id
-        lua_rawseti(L, -2, 2);						// class ... ot object
-        lua_pushlightuserdata(L, p);				// class ... ot object pGameObject
-        lua_rawseti(L, -2, 3);						// class ... ot object
-
-        // 设置对象 metatable
-        lua_rawgeti(L, -2, LOBJPOOL_METATABLE_IDX);	// class ... ot object mt
-        lua_setmetatable(L, -2);					// class ... ot object
-
-        // 设置到全局表 ot[n]
-        lua_pushvalue(L, -1);						// class ... ot object object
-        lua_rawseti(L, -3, (int)p->id + 1);			// class ... ot object
-
-    #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
-        if (!p->luaclass.IsDefaultCreate)
+        lua_pushnil(L);												// object fields nil
+        while (lua_next(L, 2))										// object fields k v
         {
-    #endif // USING_ADVANCE_GAMEOBJECT_CLASS
-            // 调用 init
-            lua_insert(L, 1);							// object class ... ot
-            lua_pop(L, 1);								// object class ...
-            lua_rawgeti(L, 2, LGOBJ_CC_INIT);			// object class ... init
-            lua_insert(L, 3);							// object class init ...
-            lua_pushvalue(L, 1);						// object class init ... object
-            lua_insert(L, 4);							// object class init object ...
-            lua_call(L, lua_gettop(L) - 3, 0);			// object class
-            lua_pop(L, 1);								// object
-
-            // TODO: 潜在的 dx、dy 值问题，可能会导致意外情况
-            // 更新初始状态
-            //p->lastx = p->x;
-            //p->lasty = p->y;
-    #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+            if (lua_type(L, 3) != LUA_TSTRING)
+                return luaL_error(L, "invalid field name in argument #2, string required.");
+            auto const member = LuaSTG::MapGameObjectMember(lua_tostring(L, 3));
+            if (member != LuaSTG::GameObjectMember::CLASS && member != LuaSTG::GameObjectMember::IMG)
+                _SetMember(L, c, member, 3, 4);
+            lua_settop(L, 3);										// object fields k
         }
-    #endif // USING_ADVANCE_GAMEOBJECT_CLASS
-
-    #if (defined(_DEBUG) && defined(LuaSTG_enable_GameObjectManager_Debug))
-        static std::string _name("<null>");
-        spdlog::debug("[object] new {}-{} (img = {})", p->id, p->uid, p->res ? p->res->GetResName() : _name);
-    #endif
-
+        _EndSetMember(L, c);
+        return 0;
+    }
+    int GameObjectPool::NewAttrSetter(lua_State* L)
+    {
+        int const count = lua_gettop(L);
+        // 上值 1 为属性数组，其余为属性名
+        if (count < 1 || count > 64)
+            return luaL_error(L, "invalid argument count, 1 to 64 field names required.");
+        auto* members = static_cast<LuaSTG::GameObjectMember*>(lua_newuserdata(L, sizeof(LuaSTG::GameObjectMember) * (size_t)count));
+        for (int i = 1; i <= count; i += 1)
+        {
+            members[i - 1] = LuaSTG::MapGameObjectMember(luaL_checkstring(L, i));
+        }
+        lua_insert(L, 1);											// members k1 k2 ...
+        lua_pushcclosure(L, &api_AttrSetter, count + 1);			// setter
         return 1;
     }
     void GameObjectPool::DirtResetObject(GameObject* p) noexcept
@@ -618,6 +3116,7 @@ namespace LuaSTGPlus
         _InsertToUpdateLinkList(p);
         _InsertToRenderList(p);
         _InsertToColliLinkList(p, (size_t)p->group);
+        _MarkColliGroupDirty(p->group);
     }
     int GameObjectPool::Del(lua_State* L, bool kill_mode)
     {
@@ -649,15 +3148,40 @@ namespace LuaSTGPlus
             lua_pushboolean(L, false);
             return 1;
         }
-        lua_rawgeti(L, 1, 3);
-        GameObject* p = (GameObject*)lua_touserdata(L, -1);
-        lua_pop(L, 1);
-        lua_pushboolean(L, p != nullptr);
+        lua_rawgeti(L, 1, 3);										// object ... p
+        lua_rawgeti(L, 1, LOBJPOOL_OBJECT_UID_IDX);					// object ... p uid
+        GameObject* p = (GameObject*)lua_touserdata(L, -2);
+        bool valid = p != nullptr && lua_type(L, -1) == LUA_TNUMBER
+            && (uint64_t)lua_tointeger(L, -1) == p->uid;
+        lua_pop(L, 2);												// object ...
+        // 传入 uid 时还要求是同一个对象，table 回收复用后旧的引用也会被视为无效
+        if (valid && !lua_isnoneornil(L, 2))
+        {
+            valid = lua_type(L, 2) == LUA_TNUMBER && (uint64_t)lua_tointeger(L, 2) == p->uid;
+        }
+        lua_pushboolean(L, valid);
         return 1;
     }
 
     bool GameObjectPool::SetImgState(GameObject* p, BlendMode m, Core::Color4B c) noexcept
     {
+    #ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+        // 图像状态保存在对象上，不修改共享的图片资源，使用相同状态的对象可以批量绘制
+        if (p->res)
+        {
+            switch (p->res->GetType())
+            {
+            case ResourceType::Sprite:
+            case ResourceType::Animation:
+                p->blendmode = m;
+                p->vertexcolor = (uint32_t(c.a) << 24) | (uint32_t(c.r) << 16) | (uint32_t(c.g) << 8) | uint32_t(c.b);
+                p->img_state = true;
+                break;
+            default:
+                break;
+            }
+        }
+    #else // USING_ADVANCE_GAMEOBJECT_CLASS
         if (p->res)
         {
             switch (p->res->GetType())
@@ -677,6 +3201,7 @@ namespace LuaSTGPlus
                 break;
             }
         }
+    #endif // USING_ADVANCE_GAMEOBJECT_CLASS
         return true;
     }
     bool GameObjectPool::SetParState(GameObject* p, BlendMode m, Core::Color4B c) noexcept
@@ -716,6 +3241,80 @@ namespace LuaSTGPlus
                 return -1;
         }
     }
+    void GameObjectPool::_InitListCursor(_ListCursor& c, lua_Integer group) noexcept
+    {
+        bool const all = group < 0 || group >= LOBJPOOL_GROUPN;
+        c.group = all ? -1 : group;
+        GameObject* p = all ? m_UpdateLinkList.first.pUpdateNext : m_ColliLinkList[group].first.pColliNext;
+        GameObject const* end = all ? &m_UpdateLinkList.second : &m_ColliLinkList[group].second;
+        c.next = (p != end) ? p : nullptr;
+        c.next_uid = c.next ? c.next->uid : 0;
+        c.last = nullptr;
+        c.last_uid = 0;
+        c.generation = m_ObjectIdGeneration;
+    }
+    GameObject* GameObjectPool::_NextListCursor(_ListCursor& c) noexcept
+    {
+        auto const in_list = [&c](GameObject const* o, uint64_t uid) -> bool
+        {
+            return o && o->status != GameObjectStatus::Free && o->uid == uid && (c.group < 0 || o->group == c.group);
+        };
+        GameObject const* end = (c.group < 0) ? &m_UpdateLinkList.second : &m_ColliLinkList[c.group].second;
+        GameObject* p = c.next;
+        if (!p || c.generation != m_ObjectIdGeneration)
+        {
+            // 已经到达链表末尾（之后追加的对象不会被遍历），或者对象池已被整理
+            c.next = nullptr;
+            c.last = nullptr;
+            return nullptr;
+        }
+        if (!in_list(p, c.next_uid))
+        {
+            // 记下的下一个对象已失效，上一个对象还在链表中时从它当前的链接继续
+            p = nullptr;
+            if (in_list(c.last, c.last_uid))
+            {
+                GameObject* n = (c.group < 0) ? c.last->pUpdateNext : c.last->pColliNext;
+                p = (n != end) ? n : nullptr;
+            }
+            if (!p)
+            {
+                c.next = nullptr;
+                c.last = nullptr;
+                return nullptr;
+            }
+        }
+        GameObject* n = (c.group < 0) ? p->pUpdateNext : p->pColliNext;
+        c.next = (n != end) ? n : nullptr;
+        c.next_uid = c.next ? c.next->uid : 0;
+        c.last = p;
+        c.last_uid = p->uid;
+        return p;
+    }
+    int GameObjectPool::ForEachInGroup(lua_State* L)
+    {
+        lua_Integer const group = luaL_checkinteger(L, 1);
+        luaL_checktype(L, 2, LUA_TFUNCTION);
+        lua_settop(L, 2);									// group fn
+        GetObjectTable(L);									// group fn ot
+        _IterationScope const scope(*this);
+        _ListCursor c;
+        _InitListCursor(c, group);
+        lua_Integer count = 0;
+        while (GameObject* p = _NextListCursor(c))
+        {
+            lua_pushvalue(L, 2);							// group fn ot fn
+            lua_rawgeti(L, 3, (int)p->id + 1);				// group fn ot fn object
+            lua_call(L, 1, 1);								// group fn ot ret
+            count += 1;
+            bool const stop = lua_isboolean(L, -1) && !lua_toboolean(L, -1);
+            lua_pop(L, 1);									// group fn ot
+            if (stop)
+                break;
+        }
+        lua_pushinteger(L, count);
+        return 1;
+    }
     int GameObjectPool::NextObject(int groupId, int id) noexcept
     {
         if (id < 0)
@@ -889,11 +3488,35 @@ namespace LuaSTGPlus
         lua_pushinteger(L, g_GameObjectPool->FirstObject(g));	// next(f) i(groupId) id(firstobj) 最后的两个参数作为迭代器参数传入
         return 3;
     }
+    int GameObjectPool::api_ObjWalk(lua_State* L)
+    {
+        // 迭代器直接遍历链表，对象 table 和遍历状态作为上值，每一步不需要查找对象 table 和检查对象序号
+        lua_Integer g = luaL_checkinteger(L, 1);				// i(groupId)
+        g_GameObjectPool->GetObjectTable(L);					// i(groupId) ot
+        auto* c = static_cast<_ListCursor*>(lua_newuserdata(L, sizeof(_ListCursor)));	// i(groupId) ot cursor
+        g_GameObjectPool->_InitListCursor(*c, g);
+        lua_pushcclosure(L, &api_ObjWalkNext, 2);				// i(groupId) next(f)
+        return 1;
+    }
+    int GameObjectPool::api_ObjWalkNext(lua_State* L) noexcept
+    {
+        auto* c = static_cast<_ListCursor*>(lua_touserdata(L, lua_upvalueindex(2)));
+        GameObject* p = g_GameObjectPool->_NextListCursor(*c);
+        if (!p)
+            return 0;
+        lua_pushinteger(L, (lua_Integer)p->id);					// id
+        lua_rawgeti(L, lua_upvalueindex(1), (int)p->id + 1);		// id t(object)
+        return 2;
+    }
 
     int GameObjectPool::api_New(lua_State* L)
     {
         return g_GameObjectPool->New(L);
     }
+    int GameObjectPool::api_NewBatch(lua_State* L)
+    {
+        return g_GameObjectPool->NewBatch(L);
+    }
     int GameObjectPool::api_ResetObject(lua_State* L) noexcept
     {
         GameObject* p = g_GameObjectPool->_TableToGameObject(L, 1);
@@ -1080,20 +3703,30 @@ namespace LuaSTGPlus
     }
     int GameObjectPool::api_SetAttr(lua_State* L)
     {
+        // self k v
         GameObject* p = g_GameObjectPool->_TableToGameObject(L, 1);
-        switch (p->SetAttr(L))
+        std::string_view const key = luaL_check_string_view(L, 2);
+        _MemberChange c;
+        g_GameObjectPool->_BeginSetMember(c, p);
+        g_GameObjectPool->_SetMember(L, c, LuaSTG::MapGameObjectMember(key.data()), 2, 3);
+        g_GameObjectPool->_EndSetMember(L, c);
+        return 0;
+    }
+    int GameObjectPool::api_AttrSetter(lua_State* L)
+    {
+        // self v1 v2 ...，上值 1 为属性数组，上值 2 开始为属性名
+        GameObject* p = g_GameObjectPool->_ToGameObject(L, 1);
+        auto const* members = static_cast<LuaSTG::GameObjectMember const*>(lua_touserdata(L, lua_upvalueindex(1)));
+        int const count = (int)(lua_objlen(L, lua_upvalueindex(1)) / sizeof(LuaSTG::GameObjectMember));
+        int const top = std::min(lua_gettop(L), count + 1);
+        _MemberChange c;
+        g_GameObjectPool->_BeginSetMember(c, p);
+        for (int i = 2; i <= top; i += 1)
         {
-        case 1: // group
-            if (p == g_GameObjectPool->m_LockObjectA || p == g_GameObjectPool->m_LockObjectB)
-                return luaL_error(L, "illegal operation, lstg object 'group' property should not be modified in 'lstg.CollisionCheck'");
-            g_GameObjectPool->_MoveToColliLinkList(p, (size_t)p->group);
-            break;
-        case 2: // layer
-            if (g_GameObjectPool->m_IsRendering)
-                return luaL_error(L, "illegal operation, lstg object 'layer' property should not be modified in 'lstg.ObjRender'");
-            g_GameObjectPool->_SetObjectLayer(p, p->nextlayer);
-            break;
+            if (!lua_isnil(L, i))
+                g_GameObjectPool->_SetMember(L, c, members[i - 2], lua_upvalueindex(i), i);
         }
+        g_GameObjectPool->_EndSetMember(L, c);
         return 0;
     }
 
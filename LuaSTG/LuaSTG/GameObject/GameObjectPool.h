@@ -1,9 +1,17 @@
 ﻿#pragma once
 #include "GameObject/GameObject.hpp"
-#include "Utility/fixed_object_pool.hpp"
+#include "GameObject/GameObjectSpatialGrid.hpp"
+#include "GameObject/GameObjectRenderList.hpp"
+#include "GameObject/GameObjectRenderBatch.hpp"
+#include "GameObject/GameObjectEmitter.hpp"
+#include "GameObject/GameObjectMotion.hpp"
+#include "Utility/chunked_object_pool.hpp"
+#include "Utility/WorkerPool.hpp"
 
 // 对象池信息
-#define LOBJPOOL_SIZE   32768 // 最大对象数 //32768(full) //16384(half)
+#define LOBJPOOL_SIZE   32768 // 默认最大对象数 //32768(full) //16384(half)
+#define LOBJPOOL_SIZE_MAX 1048576 // 可设置的最大对象数上限
+#define LOBJPOOL_CHUNK_SIZE 1024 // 对象池每次增长的对象数
 #define LOBJPOOL_GROUPN 24    // 碰撞组数
 
 namespace LuaSTGPlus
@@ -12,6 +20,21 @@ namespace LuaSTGPlus
     class GameObjectPool
     {
     public:
+        struct CollisionPair
+        {
+            size_t group_a;
+            size_t group_b;
+            lua_Integer world_mask; // 启用时两个对象都要在此 world 内才检测，否则使用默认的 world 规则
+            bool use_world_mask;
+        };
+        struct CollisionPairStatistics
+        {
+            uint32_t group_a{ 0 };
+            uint32_t group_b{ 0 };
+            uint64_t check{ 0 };
+            uint64_t callback{ 0 };
+            double time{ 0.0 }; // 毫秒
+        };
         struct FrameStatistics
         {
             uint64_t object_alloc{ 0 };
@@ -19,26 +42,22 @@ namespace LuaSTGPlus
             uint64_t object_alive{ 0 };
             uint64_t object_colli_check{ 0 };
             uint64_t object_colli_callback{ 0 };
+            uint64_t object_table_reuse{ 0 };
+            uint64_t object_render_culled{ 0 };
+            uint64_t object_render_batched{ 0 };
+            std::array<double, 4> step_time{}; // ObjStep 各阶段的耗时（毫秒）：frame、边界检查、碰撞检测、UpdateXY 与 AfterFrame
+            uint32_t colli_pair_count{ 0 };
+            std::array<CollisionPairStatistics, 32> colli_pair{}; // CollisionCheckAll 中每个碰撞对的统计，只记录前 32 个
         };
 
     private:
-        cpp::fixed_object_pool<GameObject, LOBJPOOL_SIZE> m_ObjectPool;
+        cpp::chunked_object_pool<GameObject, LOBJPOOL_CHUNK_SIZE> m_ObjectPool;
         uint64_t m_iUid = 0;
         lua_State* G_L = nullptr;
         GameObject* m_pCurrentObject = nullptr;
         
         // GameObject List
-        struct _less_render {
-            bool operator()(const GameObject* x, const GameObject* y) const {
-                if (x->layer != y->layer) {
-                    return x->layer < y->layer;
-                }
-                else {
-                    return x->uid < y->uid;
-                }
-            }
-        };
-        std::set<GameObject*, _less_render> m_RenderList;
+        GameObjectRenderList m_RenderList;
         std::pair<GameObject, GameObject> m_UpdateLinkList;
         std::array<std::pair<GameObject, GameObject>, LOBJPOOL_GROUPN> m_ColliLinkList = {};
 
@@ -50,6 +69,114 @@ namespace LuaSTGPlus
 
         bool m_IsRendering = false;
 
+        // 正在遍历对象链表并执行回调的层数（ObjFrame、BoundCheck、CollisionCheck、ForEachInGroup），为 0 时才能整理对象池
+        uint32_t m_IterationDepth = 0;
+        // 对象序号被整体重新分配（CompactPool、Restore）时递增，未结束的 ObjWalk 迭代器据此停止
+        uint64_t m_ObjectIdGeneration = 0;
+        struct _IterationScope
+        {
+            GameObjectPool& pool;
+            explicit _IterationScope(GameObjectPool& p) noexcept : pool(p) { pool.m_IterationDepth += 1; }
+            ~_IterationScope() { pool.m_IterationDepth -= 1; }
+        };
+
+        // 渲染剔除
+        struct CullRect
+        {
+            float left;
+            float right;
+            float bottom;
+            float top;
+        };
+        bool m_RenderCull = false;
+        float m_RenderCullMargin = 32.0f;
+        bool m_RenderCullUseRect = false; // 使用脚本指定的剔除矩形，否则使用当前正交投影的范围加上边距
+        CullRect m_RenderCullRect{};
+        bool m_RenderCullHasOrtho = false; // 当前相机为透视投影时不进行剔除
+        CullRect m_RenderCullOrtho{};
+
+        // 默认渲染的批量绘制
+        GameObjectRenderBatch m_RenderBatch;
+
+        // 碰撞检测宽相位
+        bool m_ColliBroadphase = false;
+        float m_ColliBroadphaseCellSize = 64.0f;
+        std::array<uint64_t, LOBJPOOL_GROUPN> m_ColliGroupVersion = {};
+        std::array<GameObjectSpatialGrid, LOBJPOOL_GROUPN> m_ColliGrid;
+
+        // 空间查询，与碰撞检测分开建立网格，查询回调中重建网格不会影响正在进行的碰撞检测
+        std::array<GameObjectSpatialGrid, LOBJPOOL_GROUPN> m_QueryGrid;
+        std::vector<uint32_t> m_QueryCandidate;
+        std::vector<GameObject*> m_QueryResultCache; // 复用的缓冲区
+        // DoFrame 期间不为 0，此时每个碰撞组的查询网格只建立一次，之后对象移动不再重建
+        uint64_t m_QueryGridFrozen = 0;
+        uint64_t m_QueryGridFrameCounter = 0;
+        std::array<uint64_t, LOBJPOOL_GROUPN> m_QueryGridFrame = {}; // 查询网格建立时的 m_QueryGridFrozen
+        struct _QueryGridFreezeScope
+        {
+            GameObjectPool& pool;
+            uint64_t const last;
+            explicit _QueryGridFreezeScope(GameObjectPool& p) noexcept : pool(p), last(p.m_QueryGridFrozen) { pool.m_QueryGridFrozen = ++pool.m_QueryGridFrameCounter; }
+            ~_QueryGridFreezeScope() { pool.m_QueryGridFrozen = last; }
+        };
+
+        // 碰撞对表
+        std::vector<CollisionPair> m_ColliPairs;
+
+        // 碰撞检测批量派发
+        struct CollisionHit
+        {
+            GameObject* a;
+            GameObject* b;
+            uint64_t uid_a;
+            uint64_t uid_b;
+            uint32_t order; // 派发时的分组，即 A 的类首次出现的顺序
+        };
+        bool m_ColliBatchDispatch = false;
+        std::vector<CollisionHit> m_ColliHitsCache; // 复用的缓冲区
+
+        // 碰撞检测并行窄相位，收集阶段不执行 lua 代码，以下缓冲区不会被重入；
+        // 只拆分同一对碰撞组内的检测，碰撞对表中的各个碰撞对仍然在主线程上逐个串行检查
+        struct CollisionChunk
+        {
+            std::vector<CollisionHit> hits;
+            std::vector<uint32_t> candidate;
+            uint64_t checks{ 0 };
+        };
+        static constexpr size_t COLLI_PARALLEL_MIN_WORK = 4096; // 估计的检测次数低于此值时不拆分任务
+        WorkerPool m_ColliWorkers;
+        std::vector<GameObject*> m_ColliListA;
+        std::vector<GameObject*> m_ColliListB;
+        std::vector<CollisionChunk> m_ColliChunks;
+
+        // 对象 table 回收
+        static constexpr size_t OBJECT_TABLE_ESTIMATED_SIZE = 96; // 估计的对象 table 内存大小（表头、数组部分），用于统计节省的内存
+        bool m_TableRecycling = false;
+        size_t m_TableCacheMax = LOBJPOOL_SIZE;
+        size_t m_TableCacheCount = 0;
+        uint64_t m_TableCacheHits = 0;
+        uint64_t m_TableCacheMisses = 0;
+
+        // 弹幕发射器，按序号升序保存
+        std::vector<GameObjectEmitter> m_Emitters;
+        uint64_t m_EmitterId = 0;
+        uint64_t m_EmitterGeneration = 0; // 发射器列表被整体替换（ResetPool、Restore）时递增
+        std::vector<GameObjectEmitter::Shot> m_EmitterShotsCache; // 复用的缓冲区
+
+        // 运动程序，序号为下标加 1，相同的程序只保存一份；已回收的程序为空，序号之后可以复用
+        std::vector<GameObjectMotion> m_Motions;
+        std::vector<uint32_t> m_MotionRefs; // lua 持有的引用数，NewMotion 增加、DelMotion 减少
+        std::vector<uint32_t> m_MotionFree; // 已回收的序号
+        std::unordered_multimap<size_t, uint32_t> m_MotionIndex; // 程序的哈希值到序号
+        bool m_MotionCollect = false; // 有 lua 不再引用的程序，需要检查对象和发射器是否还在使用
+        // 运动程序的目标快照，每个碰撞组一个，最后一个表示所有对象；每次 DoFrame 开始时清空，第一次查找时建立
+        std::array<GameObjectMotion::TargetSet, LOBJPOOL_GROUPN + 1> m_MotionTargets;
+
+        // 类缓存，序号从 1 开始，回调函数保存在对象 table 的类缓存表中；ResetPool 时清空
+        static constexpr size_t MAX_CLASS_CACHE = (size_t(1) << 24) - 1; // 受 GameObjectClass::CacheIndex 的位数限制
+        std::vector<GameObjectClass> m_ClassCache;
+        uint64_t m_ClassCacheGeneration = 0; // 类缓存被清空时递增，之前解析的类特性中的序号失效
+
         FrameStatistics m_DbgData[2]{};
         size_t m_DbgIdx{ 0 };
 
@@ -64,6 +191,51 @@ namespace LuaSTGPlus
         void _RemoveFromColliLinkList(GameObject* p);
         void _MoveToColliLinkList(GameObject* p, size_t group);
 
+        // 碰撞组内对象的增删、坐标或外接圆半径改变后，使该组的宽相位网格失效
+        inline void _MarkColliGroupDirty(lua_Integer group) noexcept
+        {
+            if (0 <= group && group < LOBJPOOL_GROUPN)
+                m_ColliGroupVersion[(size_t)group] += 1;
+        }
+        inline void _MarkAllColliGroupDirty() noexcept
+        {
+            for (auto& v : m_ColliGroupVersion)
+                v += 1;
+        }
+        inline void _MarkColliGroupDirtyIfMoved(GameObject const* p, float x, float y) noexcept
+        {
+            if (p->x != x || p->y != y)
+                _MarkColliGroupDirty(p->group);
+        }
+        GameObjectSpatialGrid* _PrepareColliGrid(size_t group);
+        GameObjectSpatialGrid* _PrepareQueryGrid(size_t group);
+        // 收集中心点可能在矩形内的存活对象，碰撞组无效时遍历所有对象
+        void _QueryCandidates(lua_Integer group, float l, float r, float b, float t, std::vector<GameObject*>& out);
+        // callback_idx 为 0 时压入对象数组，否则依次调用回调函数并压入调用次数
+        int _PushQueryResult(lua_State* L, std::vector<GameObject*> const& list, int callback_idx);
+        bool _IsRenderCulled(GameObject const* p) const noexcept;
+        inline bool _CheckCollisionWorlds(CollisionPair const& pair, GameObject const* pA, GameObject const* pB) noexcept
+        {
+            if (pair.use_world_mask)
+                return CheckWorld(pair.world_mask, pA->world) && CheckWorld(pair.world_mask, pB->world);
+        #ifdef USING_MULTI_GAME_WORLD
+            return CheckWorlds(pA->world, pB->world);
+        #else // USING_MULTI_GAME_WORLD
+            return true;
+        #endif // USING_MULTI_GAME_WORLD
+        }
+        bool _CollisionCheckPair(int ot_idx, int cc_idx, CollisionPair const& pair, GameObject* pA, GameObject* pB, GameObject* pNextB);
+        void _CollisionCheck(int ot_idx, CollisionPair const& pair);
+        void _CollisionCheckAll(int ot_idx);
+        void _CollectCollisionHits(CollisionPair const& pair, std::vector<CollisionHit>& hits);
+        void _DispatchCollisionHits(int ot_idx, std::vector<CollisionHit>& hits, bool group_by_class);
+
+        // 清空对象 table 并放入缓存，调用前对象 table 在栈顶，调用后弹出；缓存扩容时可能抛出 lua 内存错误
+        void _RecycleObjectTable(lua_State* L, int ot_idx);
+        // 压入一个对象 table，优先使用缓存
+        void _NewObjectTable(lua_State* L, int ot_idx);
+        void _ClearObjectTableCache(lua_State* L);
+
         void _InsertToRenderList(GameObject* p);
         void _RemoveFromRenderList(GameObject* p);
         void _SetObjectLayer(GameObject* object, lua_Number layer);
@@ -86,16 +258,87 @@ namespace LuaSTGPlus
         }
         
         // 释放一个对象，完全释放，返回下一个可用的对象（可能为nullptr）
-        GameObject* _FreeObject(GameObject* p, int ot_at = 0) noexcept;
+        GameObject* _FreeObject(GameObject* p, int ot_at = 0);
+
+        // 以下函数使用调用者压入的对象 table 和类缓存表，供 DoFrame 等函数和 Step 共用
+        void _DoFrame(int ot_idx, int cc_idx);
+        void _BoundCheck(int ot_idx, int cc_idx);
+        void _UpdateXYAndAfterFrame(int ot_at);
+
+        // 申请一个对象并压入新的对象 table，不设置类特性也不调用 init，对象池已满时返回 nullptr 且不压栈
+        GameObject* _PushNewObject(lua_State* L, int class_idx, int ot_idx);
+        // 为已经分配的对象压入新的对象 table
+        void _PushObjectTable(lua_State* L, GameObject* p, int class_idx, int ot_idx);
+        // 根据序号和 uid 查找存活的对象，对象已经回收或失效时返回 nullptr
+        GameObject* _FindObject(size_t id, uint64_t uid) noexcept;
+        
+        // 更新发射器并发射子弹，在 frame 回调之前执行，新的子弹在同一帧内更新
+        void _UpdateEmitters(int ot_idx, lua_Integer superpause);
+        GameObjectEmitter* _FindEmitter(uint64_t id) noexcept;
+
+        struct _MotionTargetFinder;
+        // 执行对象的运动程序，程序要求删除对象时返回 false
+        bool _UpdateMotion(GameObject* p, int ot_idx, int cc_idx);
+        // 查找碰撞组中离对象最近的存活对象，碰撞组无效时查找所有对象；
+        // 目标坐标在这一帧第一次查找该碰撞组时确定，之后移动、创建或回收的对象不影响这一帧的结果
+        bool _FindNearestInGroup(GameObject const* self, lua_Integer group, float& x, float& y);
+        // 查找或者加入运动程序，不改变引用数，返回序号
+        uint32_t _InternMotion(GameObjectMotion&& motion);
+        // 回收 lua 不再引用、也没有对象和发射器使用的运动程序
+        void _CollectMotions();
+        bool _IsMotionValid(uint32_t motion) const noexcept { return motion != 0 && motion <= m_Motions.size() && !m_Motions[motion - 1].IsEmpty(); }
+
+        // 一次或多次设置对象属性，碰撞组和图层的改变在 _EndSetMember 中统一处理；
+        // 中途出错时对象仍然在原来的碰撞组和图层中
+        struct _MemberChange
+        {
+            GameObject* object;
+            lua_Integer group;
+            lua_Integer next_group;
+            float x;
+            float y;
+            float col_r;
+            bool swept;
+            bool moved;
+            bool layer_changed;
+        };
+        void _BeginSetMember(_MemberChange& c, GameObject* p) noexcept;
+        void _SetMember(lua_State* L, _MemberChange& c, LuaSTG::GameObjectMember member, int ki, int vi);
+        void _EndSetMember(lua_State* L, _MemberChange& c);
+
+        // 遍历更新链表或碰撞组链表，取出对象前先记下下一个对象；
+        // 下一个对象在回调中被回收、复用或移到其他碰撞组时，改从上一个取出的对象当前的链接继续，
+        // 两者都失效，或者对象池被整理、恢复快照时停止遍历
+        struct _ListCursor
+        {
+            lua_Integer group; // 无效的碰撞组表示更新链表
+            GameObject* next;
+            uint64_t next_uid;
+            GameObject* last;
+            uint64_t last_uid;
+            uint64_t generation; // 创建时的 m_ObjectIdGeneration
+        };
+        void _InitListCursor(_ListCursor& c, lua_Integer group) noexcept;
+        GameObject* _NextListCursor(_ListCursor& c) noexcept;
 
         GameObject* _ToGameObject(lua_State* L, int idx);
         GameObject* _TableToGameObject(lua_State* L, int idx);
 
-        void _GameObjectCallback(lua_State* L, int otidx, GameObject* p, int cbidx);
+        void _GameObjectCallback(lua_State* L, int otidx, int ccidx, GameObject* p, int cbidx);
+
+        // 解析类特性，首次遇到的类会加入类缓存
+        void _ResolveClass(lua_State* L, int class_idx, int ot_idx, GameObjectClass& out);
+        // 重新读取缓存中指定类的特性和回调函数
+        void _RefreshClassCache(lua_State* L, int cc_idx, size_t index);
+        // 创建类到类缓存序号的弱键表
+        static void _NewClassIndexTable(lua_State* L);
+        // 清空类缓存，调用前必须已经回收所有对象
+        void _ClearClassCache(lua_State* L, int ot_idx);
 
     public:
         void DebugNextFrame();
         FrameStatistics DebugGetFrameStatistics();
+        FrameStatistics DebugGetCurrentFrameStatistics();
 
     public:
         int PushCurrentObject(lua_State* L) noexcept;
@@ -108,6 +351,12 @@ namespace LuaSTGPlus
         /// @brief 获取已分配对象数量
         size_t GetObjectCount() noexcept { return m_ObjectPool.size(); }
         
+        /// @brief 获取最大对象数量
+        size_t GetObjectCapacity() const noexcept { return m_ObjectPool.max_size(); }
+
+        /// @brief 获取已分配内存的对象数量
+        size_t GetObjectReserved() const noexcept { return m_ObjectPool.reserved_size(); }
+        
         /// @brief 获取对象
         GameObject* GetPooledObject(size_t i) noexcept { return m_ObjectPool.object(i); }
         
@@ -141,32 +390,201 @@ namespace LuaSTGPlus
         /// @param[in] groupB 对象组B
         void CollisionCheck(size_t groupA, size_t groupB);
         
+        /// @brief 设置碰撞对表，供 CollisionCheckAll 使用
+        void SetCollisionPairs(std::vector<CollisionPair> const& pairs);
+        
+        /// @brief 按顺序检查碰撞对表中的所有碰撞对，结果与依次调用 CollisionCheck 相同
+        /// @note 碰撞对之间串行执行（前一对的回调可能影响后一对），工作线程只拆分单个碰撞对内部的检测
+        void CollisionCheckAll();
+        
+        /// @brief 设置碰撞检测宽相位
+        /// @param[in] enable 是否启用均匀网格宽相位，启用后回调结果和顺序与逐对检测一致
+        /// @param[in] cell_size 网格大小
+        void SetCollisionBroadphase(bool enable, float cell_size) noexcept
+        {
+            m_ColliBroadphase = enable;
+            m_ColliBroadphaseCellSize = std::max(cell_size, 1.0f);
+            _MarkAllColliGroupDirty();
+        }
+        
+        /// @brief 使碰撞组的宽相位网格失效
+        /// @note 绕过属性设置直接修改坐标或碰撞体积（例如通过 lstg.ObjView）后需要调用，否则之后的碰撞检测和查询可能漏掉对象
+        /// @param[in] group 碰撞组，无效的碰撞组表示所有碰撞组
+        void InvalidateCollisionGroup(lua_Integer group) noexcept
+        {
+            if (0 <= group && group < LOBJPOOL_GROUPN)
+                _MarkColliGroupDirty(group);
+            else
+                _MarkAllColliGroupDirty();
+        }
+        
+        /// @brief 设置碰撞回调批量派发
+        /// @param[in] enable 启用后先收集一对碰撞组的所有碰撞对，再按 A 的类分组执行回调，回调顺序会改变
+        void SetCollisionBatchDispatch(bool enable) noexcept { m_ColliBatchDispatch = enable; }
+        
+        /// @brief 设置碰撞检测工作线程数
+        /// @param[in] count 大于 0 时在工作线程上并行执行几何检测，再按检测顺序在主线程上派发回调；
+        ///                  回调看到的碰撞对基于检测开始时的状态
+        void SetCollisionWorkerCount(size_t count) { m_ColliWorkers.SetThreadCount(count); }
+        
+        /// @brief 收集碰撞对，不执行回调
+        /// @param[in] groupA 对象组A
+        /// @param[in] groupB 对象组B
+        /// @return 压入两个等长的对象数组 A、B 以及碰撞对数量
+        int CollisionCheckList(lua_State* L, size_t groupA, size_t groupB);
+        
+        /// @brief 查询中心点在圆内的对象
+        /// @param[in] group 碰撞组，无效的碰撞组表示所有对象
+        /// @param[in] sorted 是否按距离从近到远排序，否则按碰撞组链表顺序
+        /// @param[in] callback_idx 回调函数在栈上的位置，为 0 时压入对象数组，否则对每个对象调用回调函数并压入调用次数
+        /// @note ObjFrame 的回调中，每个碰撞组的网格在这一帧第一次查询时建立，之后移动的对象按建立时的位置查找，
+        ///       这一帧新建的对象不会被查到；结果中对象的位置总是满足查询条件
+        int QueryCircle(lua_State* L, lua_Integer group, float x, float y, float radius, bool sorted, int callback_idx);
+        
+        /// @brief 查询中心点在矩形内的对象，参数和返回值与 QueryCircle 相同
+        /// @note 调用者保证 l <= r、b <= t 且都不是 NaN，lua 接口会交换颠倒的边界
+        int QueryRect(lua_State* L, lua_Integer group, float l, float r, float b, float t, int callback_idx);
+        
+        /// @brief 查询中心点距离最近的对象
+        /// @param[in] max_dist 最大距离，为无穷大时不限制
+        /// @return 压入对象和距离，没有对象时压入 nil
+        /// @note 不限制距离时不使用网格，遍历碰撞组（或所有对象）的链表，开销与对象数量成正比；
+        ///       对象数量多时应给出最大距离
+        int QueryNearest(lua_State* L, lua_Integer group, float x, float y, float max_dist);
+        
         /// @brief 更新对象的XY坐标偏移量
         void UpdateXY() noexcept;
         
         /// @brief 帧末更新函数
-        void AfterFrame() noexcept;
+        void AfterFrame();
+        
+        /// @brief 依次执行 DoFrame、BoundCheck、CollisionCheckAll（可选）、UpdateXY、AfterFrame，
+        ///        回调顺序与分别调用相同，UpdateXY 和 AfterFrame 合并为一次遍历
+        /// @param[in] collision 是否在边界检查之后执行 CollisionCheckAll
+        /// @return 压入各阶段的耗时（毫秒）：frame、边界检查、碰撞检测、UpdateXY 与 AfterFrame
+        int Step(lua_State* L, bool collision);
         
         /// @brief 创建新对象
         int New(lua_State* L);
         
+        /// @brief 设置对象 table 回收
+        /// @param[in] enable 启用后回收的对象 table 会被清空并给之后创建的对象复用，复用后已回收对象的引用会指向新对象；
+        ///            需要跨帧持有对象引用时同时保存 uid，用 lstg.IsValid(object, uid) 检查
+        /// @param[in] max_count 缓存的对象 table 数量上限
+        void SetObjectTableRecycling(bool enable, size_t max_count);
+        
+        /// @brief 获取对象 table 回收信息
+        /// @return 压入缓存数量、命中次数、未命中次数、估计节省的内存字节数
+        /// @note 节省的内存只是估计值：按每次命中节省 OBJECT_TABLE_ESTIMATED_SIZE 字节计算，不是实际测量的分配量
+        int GetObjectTableRecyclingInfo(lua_State* L) noexcept;
+
+        /// @brief 重新读取类缓存，类的回调函数或 default_function 修改后需要调用
+        /// @note 参数 1 为类，为空时刷新所有已缓存的类
+        int RefreshClass(lua_State* L);
+        
+        /// @brief 批量创建新对象
+        /// @note 参数为 (class, n, params, ...)，params 中的 x、y、vx、vy、rot、group、layer 可以是数值或数组，img 可以是字符串或数组，
+        ///       pattern 可选 ring、arc、fan，配合 angle、spread、speed、radius 生成分布；
+        ///       属性填充完成后才调用 init，参数与 New 相同，为 (object, ...)，每个对象相同，默认创建的类不调用 init；
+        ///       返回对象数组，顺序与序号相同；
+        ///       容量、碰撞组和图像在分配前检查，但 init 出错（或在 init 中创建对象用尽对象池）时已经创建的对象会保留，不会回滚
+        int NewBatch(lua_State* L);
+        
+        /// @brief 创建弹幕发射器
+        /// @note 参数为描述表，class 为子弹类，其余字段见 GameObjectEmitter；owner 为附着对象，aim 为瞄准对象；
+        ///       img 在创建时查找，找不到时报错；子弹在 ObjFrame 开始时由 C++ 创建，只有子弹类定义了 init 时才会调用 lua；返回发射器序号
+        int NewEmitter(lua_State* L);
+        
+        /// @brief 删除发射器，发射器不存在时返回 false
+        bool DelEmitter(lua_State* L, uint64_t id);
+        
+        /// @brief 暂停或恢复发射器，暂停期间计时器也停止
+        bool SetEmitterActive(uint64_t id, bool active) noexcept;
+        
+        /// @brief 设置发射器位置，有附着对象时为相对附着对象的偏移
+        bool SetEmitterPosition(uint64_t id, float x, float y) noexcept;
+        
+        /// @brief 检查发射器是否存在
+        bool IsEmitterValid(uint64_t id) noexcept { return _FindEmitter(id) != nullptr; }
+        
+        /// @brief 创建运动程序
+        /// @note 参数为片段数组，每个片段为 { op = "speed"|"accel"|"angle"|"turn"|"aim"|"home"|"del", at = 开始帧, time = 持续帧数, value = 数值, group = 目标碰撞组 }；
+        ///       返回运动程序序号，内容相同的程序返回同一个序号，每次调用都增加一个引用
+        int NewMotion(lua_State* L);
+        
+        /// @brief 释放 NewMotion 返回的一个引用，序号无效或者没有引用时返回 false
+        /// @note 引用为 0 后，正在使用这个程序的对象和发射器仍然可以运行到结束；
+        ///       之后调用 NewMotion 创建新程序或者 ResetPool 时回收，序号可能被新的程序复用
+        bool DelMotion(uint32_t motion) noexcept;
+        
+        /// @brief 设置对象的运动程序，motion 为 0 时取消，序号无效时返回 false
+        /// @note 运动程序在对象更新时、frame 回调之前执行，不需要 frame 回调，没有 frame 回调的对象也会运行运动程序
+        bool SetMotion(GameObject* p, uint32_t motion) noexcept;
+        
+        /// @brief 保存对象池快照
+        /// @note 返回快照 table：data 为对象、链表顺序、uid 计数、超级暂停、world、边界和发射器的二进制数据，
+        ///       classes、emitters 为对象类和子弹类的引用；hook(object) 的返回值按对象顺序保存在 values 中，用于保存 lua 侧的字段；
+        ///       只能在帧之间调用，对象回调和 ForEachInGroup 中调用会报错；快照只在当前进程内有效
+        int Snapshot(lua_State* L);
+        
+        /// @brief 恢复对象池快照
+        /// @note 回收现有的所有对象（不调用回调函数），按快照的更新顺序重建对象和对象 table，对象序号从 0 开始重新分配；
+        ///       全部对象重建后调用 hook(object, value) 恢复 lua 侧的字段；返回恢复的对象数量；
+        ///       和 Snapshot 一样只能在帧之间调用，没有遍历结束的 ObjWalk 迭代器之后直接结束
+        int Restore(lua_State* L);
+        
+        /// @brief 批量设置对象属性
+        /// @note 参数为 (object, fields)，class 和 img 最先设置，其余字段按 table 遍历顺序设置；
+        ///       碰撞组和图层的链表移动在所有字段设置完成后只进行一次
+        int SetAttrs(lua_State* L);
+        
+        /// @brief 创建按位置设置属性的函数
+        /// @note 参数为属性名，返回 function(object, ...)，依次把参数设置到对应的属性，值为 nil 的属性跳过；
+        ///       属性名只在创建时解析一次
+        int NewAttrSetter(lua_State* L);
+        
         /// @brief 通知对象删除
         int Del(lua_State* L, bool kill_mode = false);
         
         /// @brief 检查对象是否有效
+        /// @note 参数为 (object[, uid])；uid 为 lstg.ObjView 返回的 uid 或者对象 table 的 [5]，
+        ///       传入时还检查对象是否仍然是同一个对象，启用对象 table 回收时用于识别指向复用 table 的旧引用
         int IsValid(lua_State* L) noexcept;
         
         //重置对象的各项属性，并释放资源，保留uid和id
         void DirtResetObject(GameObject* p) noexcept;
         
         /// @brief 设置元素的图像状态
+        /// @note 启用 USING_ADVANCE_GAMEOBJECT_CLASS 时状态保存在对象上，只影响该对象的默认渲染，不修改图片资源
         bool SetImgState(GameObject* p, BlendMode m, Core::Color4B c) noexcept;
         
         /// @brief 特化设置HGE粒子的渲染状态
         bool SetParState(GameObject* p, BlendMode m, Core::Color4B c) noexcept;
         
         /// @brief 清空对象池
-        void ResetPool() noexcept;
+        void ResetPool();
+
+        /// @brief 整理对象池，按更新顺序把存活的对象重新编号到序号最小的位置，返回被移动的对象数量
+        /// @note 只能在帧之间调用，不能在对象回调、渲染和碰撞检测中调用，对象 table 不变但对象的 ID 会改变
+        /// @note 没有遍历结束的 ObjWalk 迭代器之后直接结束；
+        ///       整理后之前取得的对象视图（lstg.ObjView）指向其他对象，NextObject 使用的对象序号也全部失效
+        int CompactPool(lua_State* L);
+
+        /// @brief 设置渲染剔除，启用后图像完全在剔除矩形外的对象会跳过渲染回调
+        /// @param[in] margin 默认剔除矩形为当前正交投影的范围向外扩展的距离
+        void SetRenderCulling(bool enable, float margin) noexcept;
+
+        /// @brief 指定剔除矩形，代替当前正交投影的范围
+        void SetRenderCullRect(float left, float right, float bottom, float top) noexcept;
+
+        /// @brief 取消指定的剔除矩形
+        void ResetRenderCullRect() noexcept;
+
+        /// @brief 记录当前正交投影的范围，由渲染器设置相机时调用
+        void SetRenderCullOrtho(float left, float right, float bottom, float top) noexcept;
+
+        /// @brief 当前相机不是正交投影，由渲染器设置相机时调用
+        void ResetRenderCullOrtho() noexcept;
         
         /// @brief 获取下一个元素的ID
         /// @return 返回-1表示无元素
@@ -177,6 +595,10 @@ namespace LuaSTGPlus
         /// @return 返回-1表示无元素
         int FirstObject(int groupId) noexcept;
         
+        /// @brief 依次对碰撞组中的对象调用函数
+        /// @note 参数为 (group, fn)，碰撞组无效时遍历所有对象；fn 返回 false 时停止；返回调用次数
+        int ForEachInGroup(lua_State* L);
+        
         /// @brief 调试目的，获取对象列表
         int GetObjectTable(lua_State* L) noexcept;
     private:
@@ -252,8 +674,13 @@ namespace LuaSTGPlus
 
         static int api_NextObject(lua_State* L) noexcept;
         static int api_ObjList(lua_State* L);
+        /// @brief lstg.ObjWalk(group)，返回一个有状态的迭代函数，每次调用返回 id, object，用法和 ObjList 相同
+        /// @note 直接遍历链表，不像 ObjList 每一步都查找对象 table 和检查对象序号；每次调用会分配一个 userdata 和一个闭包
+        static int api_ObjWalk(lua_State* L);
+        static int api_ObjWalkNext(lua_State* L) noexcept;
 
         static int api_New(lua_State* L);
+        static int api_NewBatch(lua_State* L);
         static int api_ResetObject(lua_State* L) noexcept;
         static int api_Del(lua_State* L);
         static int api_Kill(lua_State* L);
@@ -269,6 +696,7 @@ namespace LuaSTGPlus
         static int api_SetParState(lua_State* L);
         static int api_GetAttr(lua_State* L);
         static int api_SetAttr(lua_State* L);
+        static int api_AttrSetter(lua_State* L);
 
         static int api_DefaultRenderFunc(lua_State* L);
 
@@ -279,7 +707,8 @@ namespace LuaSTGPlus
         static int api_ParticleSetEmission(lua_State* L);
 
     public:
-        GameObjectPool(lua_State* pL);
+        /// @param[in] capacity 最大对象数量，对象按块分配，不会一次性占用全部内存
+        GameObjectPool(lua_State* pL, size_t capacity = LOBJPOOL_SIZE);
         GameObjectPool& operator=(const GameObjectPool&) = delete;
         GameObjectPool(const GameObjectPool&) = delete;
         ~GameObjectPool();
@@ -0,0 +1,160 @@
+﻿#include "GameObject/GameObjectRenderBatch.hpp"
+#include "AppFrame.h"
+
+namespace LuaSTGPlus
+{
+	void GameObjectRenderBatch::_UpdateSprite(Core::Graphics::ISprite* sprite) noexcept
+	{
+		// 与 Sprite::updateRect 的计算相同
+		m_Sprite = sprite;
+		Core::RectF const rect = sprite->getTextureRect();
+		Core::Vector2F const center = sprite->getTextureCenter();
+		float const unit = sprite->getUnitsPerPixel();
+		Core::Vector2U const size = sprite->getTexture()->getSize();
+		float const uscale = 1.0f / (float)size.x;
+		float const vscale = 1.0f / (float)size.y;
+		m_UV = rect;
+		m_UV.a.x *= uscale;
+		m_UV.a.y *= vscale;
+		m_UV.b.x *= uscale;
+		m_UV.b.y *= vscale;
+		m_PosRect = rect - center;
+		m_PosRect.a.x *= unit;
+		m_PosRect.a.y *= -unit;
+		m_PosRect.b.x *= unit;
+		m_PosRect.b.y *= -unit;
+		sprite->getColor(m_SpriteColor);
+	}
+
+	bool GameObjectRenderBatch::IsBatchable(GameObject const* p) noexcept
+	{
+	#ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+		if (!p->luaclass.IsDefaultRender || !p->res)
+			return false;
+		ResourceType const type = p->res->GetType();
+		return type == ResourceType::Sprite || type == ResourceType::Animation;
+	#else // USING_ADVANCE_GAMEOBJECT_CLASS
+		std::ignore = p;
+		return false;
+	#endif // USING_ADVANCE_GAMEOBJECT_CLASS
+	}
+
+	void GameObjectRenderBatch::Draw(GameObject const* p) noexcept
+	{
+		if (!m_Renderer)
+		{
+			m_Renderer = LAPP.GetAppModel()->getRenderer();
+		}
+
+		// 确定精灵、混合模式和顶点颜色，和 GameObject::Render 相同
+
+		Core::Graphics::ISprite* sprite = nullptr;
+		BlendMode blend = BlendMode::MulAlpha;
+		Core::Color4B color[4];
+		bool use_sprite_color = false;
+		if (p->res->GetType() == ResourceType::Sprite)
+		{
+			auto* res = static_cast<IResourceSprite*>(p->res);
+			sprite = res->GetSprite();
+			blend = res->GetBlendMode();
+			use_sprite_color = true;
+		}
+		else
+		{
+			auto* res = static_cast<IResourceAnimation*>(p->res);
+			sprite = res->GetSpriteByTimer(static_cast<int>(p->ani_timer))->GetSprite();
+			blend = res->GetBlendMode();
+			res->GetVertexColor(color);
+		}
+	#ifdef USING_ADVANCE_GAMEOBJECT_CLASS
+		if (p->HasImgState())
+		{
+			blend = p->blendmode;
+			color[0] = color[1] = color[2] = color[3] = Core::Color4B(p->vertexcolor);
+			use_sprite_color = false;
+		}
+	#endif // USING_ADVANCE_GAMEOBJECT_CLASS
+
+		// 只在改变时设置状态
+
+		if (sprite != m_Sprite)
+		{
+			_UpdateSprite(sprite);
+		}
+		if (!m_HasBlendMode || blend != m_BlendMode)
+		{
+			LAPP.updateGraph2DBlendMode(blend);
+			m_BlendMode = blend;
+			m_HasBlendMode = true;
+		}
+		Core::Graphics::ITexture2D* texture = sprite->getTexture();
+		if (texture != m_Texture)
+		{
+			m_Renderer->setTexture(texture);
+			m_Texture = texture;
+		}
+		if (use_sprite_color)
+		{
+			color[0] = m_SpriteColor[0];
+			color[1] = m_SpriteColor[1];
+			color[2] = m_SpriteColor[2];
+			color[3] = m_SpriteColor[3];
+		}
+
+		// 生成顶点，与 Sprite::draw(pos, scale, rotation) 相同，z 为默认的 0.5
+
+		float const gscale = LRES.GetGlobalImageScaleFactor();
+		float const sx = static_cast<float>(p->hscale) * gscale;
+		float const sy = static_cast<float>(p->vscale) * gscale;
+		float const z = 0.5f;
+		float const l = m_PosRect.a.x * sx;
+		float const t = m_PosRect.a.y * sy;
+		float const r = m_PosRect.b.x * sx;
+		float const b = m_PosRect.b.y * sy;
+
+		Core::Graphics::IRenderer::DrawVertex* vert = nullptr;
+		Core::Graphics::IRenderer::DrawIndex* index = nullptr;
+		uint16_t offset = 0;
+		if (!m_Renderer->drawRequest(4, 6, &vert, &index, &offset))
+		{
+			return;
+		}
+		vert[0] = Core::Graphics::IRenderer::DrawVertex(l, t, z, m_UV.a.x, m_UV.a.y, color[0].color());
+		vert[1] = Core::Graphics::IRenderer::DrawVertex(r, t, z, m_UV.b.x, m_UV.a.y, color[1].color());
+		vert[2] = Core::Graphics::IRenderer::DrawVertex(r, b, z, m_UV.b.x, m_UV.b.y, color[2].color());
+		vert[3] = Core::Graphics::IRenderer::DrawVertex(l, b, z, m_UV.a.x, m_UV.b.y, color[3].color());
+		float const rot = static_cast<float>(p->rot);
+		if (std::abs(rot) >= std::numeric_limits<float>::min())
+		{
+			float const sinv = std::sin(rot);
+			float const cosv = std::cos(rot);
+			for (int i = 0; i < 4; i += 1)
+			{
+				float const tx = vert[i].x * cosv - vert[i].y * sinv;
+				float const ty = vert[i].x * sinv + vert[i].y * cosv;
+				vert[i].x = tx;
+				vert[i].y = ty;
+			}
+		}
+		float const x = static_cast<float>(p->x);
+		float const y = static_cast<float>(p->y);
+		for (int i = 0; i < 4; i += 1)
+		{
+			vert[i].x += x;
+			vert[i].y += y;
+		}
+		index[0] = offset;
+		index[1] = offset + 1;
+		index[2] = offset + 2;
+		index[3] = offset;
+		index[4] = offset + 2;
+		index[5] = offset + 3;
+	}
+
+	void GameObjectRenderBatch::Reset() noexcept
+	{
+		m_Sprite = nullptr;
+		m_Texture = nullptr;
+		m_HasBlendMode = false;
+	}
+}
@@ -0,0 +1,35 @@
+﻿#pragma once
+#include "GameObject/GameObject.hpp"
+#include "Core/Graphics/Renderer.hpp"
+#include "Core/Graphics/Sprite.hpp"
+
+namespace LuaSTGPlus
+{
+	// 默认渲染的批量绘制
+	// 使用默认渲染的精灵、动画对象直接把顶点写入渲染器的绘制列表，不经过图片资源，也不修改资源的混合模式和顶点颜色；
+	// 连续绘制时只在精灵、纹理、混合模式改变时重新设置状态
+	class GameObjectRenderBatch
+	{
+	private:
+		Core::Graphics::IRenderer* m_Renderer{ nullptr };
+		Core::Graphics::ISprite* m_Sprite{ nullptr };   // 当前几何数据对应的精灵
+		Core::Graphics::ITexture2D* m_Texture{ nullptr };
+		BlendMode m_BlendMode{ BlendMode::MulAlpha };
+		bool m_HasBlendMode{ false };
+		Core::RectF m_UV;                               // 纹理坐标
+		Core::RectF m_PosRect;                          // 相对于中心点的顶点坐标，已经乘以每像素单位长度
+		Core::Color4B m_SpriteColor[4];                 // 精灵本身的顶点颜色
+
+		void _UpdateSprite(Core::Graphics::ISprite* sprite) noexcept;
+
+	public:
+		/// @brief 检查对象是否可以批量绘制，只有使用默认渲染的精灵和动画对象可以
+		static bool IsBatchable(GameObject const* p) noexcept;
+
+		/// @brief 绘制一个对象，对象必须可以批量绘制
+		void Draw(GameObject const* p) noexcept;
+
+		/// @brief 清空缓存的状态，在其他代码可能修改渲染状态或精灵之前调用
+		void Reset() noexcept;
+	};
+}
@@ -0,0 +1,106 @@
+﻿#include "GameObject/GameObjectRenderList.hpp"
+
+namespace LuaSTGPlus
+{
+	size_t GameObjectRenderList::_LowerBound(lua_Number layer) const noexcept
+	{
+		auto const it = std::lower_bound(m_Buckets.begin(), m_Buckets.end(), layer, [](Bucket const& b, lua_Number v) { return b.layer < v; });
+		return (size_t)(it - m_Buckets.begin());
+	}
+
+	void GameObjectRenderList::_Seek(Entry const& e, size_t& bucket, size_t& item) const noexcept
+	{
+		bucket = _LowerBound(e.layer);
+		item = 0;
+		if (bucket < m_Buckets.size() && m_Buckets[bucket].layer == e.layer)
+		{
+			auto const& items = m_Buckets[bucket].items;
+			auto const it = std::upper_bound(items.begin(), items.end(), e.uid, [](uint64_t v, Entry const& x) { return v < x.uid; });
+			item = (size_t)(it - items.begin());
+		}
+	}
+
+	void GameObjectRenderList::Insert(GameObject* p)
+	{
+		m_Pending.push_back(Entry{ p, p->uid, p->layer });
+	}
+
+	void GameObjectRenderList::Remove(GameObject* p) noexcept
+	{
+		// 只标记所在图层，失效的记录在合并时清理
+		size_t const i = _LowerBound(p->layer);
+		if (i < m_Buckets.size() && m_Buckets[i].layer == p->layer)
+		{
+			m_Buckets[i].dirty = true;
+			m_Dirty = true;
+		}
+	}
+
+	void GameObjectRenderList::Flush()
+	{
+		// 清理失效记录
+
+		if (m_Dirty)
+		{
+			for (auto& b : m_Buckets)
+			{
+				if (b.dirty)
+				{
+					std::erase_if(b.items, [](Entry const& e) { return !_IsValid(e); });
+					b.dirty = false;
+				}
+			}
+			std::erase_if(m_Buckets, [](Bucket const& b) { return b.items.empty(); });
+			m_Dirty = false;
+		}
+
+		// 合并待处理的对象
+
+		if (m_Pending.empty())
+		{
+			return;
+		}
+		std::erase_if(m_Pending, [](Entry const& e) { return !_IsValid(e); });
+		std::sort(m_Pending.begin(), m_Pending.end(), [](Entry const& a, Entry const& b) {
+			if (a.layer != b.layer)
+				return a.layer < b.layer;
+			return a.uid < b.uid;
+		});
+		auto const same_uid = [](Entry const& a, Entry const& b) { return a.uid == b.uid; };
+		m_Pending.erase(std::unique(m_Pending.begin(), m_Pending.end(), same_uid), m_Pending.end());
+		for (size_t i = 0; i < m_Pending.size();)
+		{
+			lua_Number const layer = m_Pending[i].layer;
+			size_t j = i + 1;
+			while (j < m_Pending.size() && m_Pending[j].layer == layer)
+			{
+				j += 1;
+			}
+			size_t const bi = _LowerBound(layer);
+			if (bi == m_Buckets.size() || m_Buckets[bi].layer != layer)
+			{
+				m_Buckets.insert(m_Buckets.begin() + (ptrdiff_t)bi, Bucket{ layer, false, {} });
+			}
+			auto& items = m_Buckets[bi].items;
+			bool const append = items.empty() || items.back().uid < m_Pending[i].uid;
+			size_t const mid = items.size();
+			items.insert(items.end(), m_Pending.begin() + (ptrdiff_t)i, m_Pending.begin() + (ptrdiff_t)j);
+			if (!append)
+			{
+				// 修改图层后又改回来、重新分配 uid 的对象可能排在中间，甚至已经在列表中
+				auto const by_uid = [](Entry const& a, Entry const& b) { return a.uid < b.uid; };
+				std::inplace_merge(items.begin(), items.begin() + (ptrdiff_t)mid, items.end(), by_uid);
+				items.erase(std::unique(items.begin(), items.end(), same_uid), items.end());
+			}
+			i = j;
+		}
+		m_Pending.clear();
+	}
+
+	void GameObjectRenderList::Clear() noexcept
+	{
+		m_Buckets.clear();
+		m_Pending.clear();
+		m_Dirty = false;
+	}
+}
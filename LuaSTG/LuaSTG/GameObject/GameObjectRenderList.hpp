@@ -0,0 +1,85 @@
+﻿#pragma once
+#include "GameObject/GameObject.hpp"
+
+namespace LuaSTGPlus
+{
+	// 渲染列表
+	// 按 (layer, uid) 排序，每个图层一个连续数组；插入先进入待处理表，移除只标记图层，
+	// 下一次 Flush 时批量合并，避免每次创建、回收、修改图层都进行红黑树插入删除
+	class GameObjectRenderList
+	{
+	private:
+		struct Entry
+		{
+			GameObject* object;
+			uint64_t uid;
+			lua_Number layer;
+		};
+
+		struct Bucket
+		{
+			lua_Number layer;
+			bool dirty;                 // 可能含有失效的对象
+			std::vector<Entry> items;   // 按 uid 升序
+		};
+
+		std::vector<Bucket> m_Buckets;  // 按 layer 升序
+		std::vector<Entry> m_Pending;   // 待合并的对象
+		bool m_Dirty{ false };
+
+		static inline bool _IsValid(Entry const& e) noexcept
+		{
+			// 对象被回收、重新分配 uid、修改图层后，旧的记录就失效了
+			return e.object->status != GameObjectStatus::Free && e.object->uid == e.uid && e.object->layer == e.layer;
+		}
+
+		size_t _LowerBound(lua_Number layer) const noexcept;
+		void _Seek(Entry const& e, size_t& bucket, size_t& item) const noexcept;
+
+	public:
+		/// @brief 插入对象，对象的 layer 和 uid 此时必须已经确定
+		void Insert(GameObject* p);
+
+		/// @brief 移除对象，必须在修改对象的 layer、uid 或回收对象前调用
+		void Remove(GameObject* p) noexcept;
+
+		/// @brief 合并所有待处理的修改
+		void Flush();
+
+		void Clear() noexcept;
+
+		/// @brief 按 (layer, uid) 顺序遍历所有对象
+		/// @note 遍历过程中可以创建对象、修改图层，效果和遍历有序集合相同：排在当前对象后面的对象也会被遍历到
+		template<typename F>
+		void ForEach(F&& f)
+		{
+			Flush();
+			size_t bi = 0;
+			size_t ii = 0;
+			while (bi < m_Buckets.size())
+			{
+				if (ii >= m_Buckets[bi].items.size())
+				{
+					bi += 1;
+					ii = 0;
+					continue;
+				}
+				Entry const e = m_Buckets[bi].items[ii];
+				if (_IsValid(e))
+				{
+					f(e.object);
+				}
+				if (m_Dirty || !m_Pending.empty())
+				{
+					// 回调中修改了列表，合并后重新定位到当前对象之后
+					Flush();
+					_Seek(e, bi, ii);
+				}
+				else
+				{
+					ii += 1;
+				}
+			}
+		}
+	};
+}
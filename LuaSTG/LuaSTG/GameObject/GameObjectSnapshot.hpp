@@ -0,0 +1,103 @@
+﻿#pragma once
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <type_traits>
+#include <initializer_list>
+
+namespace LuaSTGPlus
+{
+	// 快照的二进制读写
+	// 数据按本机字节序和结构体布局直接复制，只能在同一个程序内保存和恢复，不能作为存档格式
+	class GameObjectSnapshotWriter
+	{
+	private:
+		std::string& m_Data;
+
+	public:
+		template<typename T>
+		void Write(T const& v)
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			m_Data.append(reinterpret_cast<char const*>(&v), sizeof(T));
+		}
+		void WriteString(std::string_view const& s)
+		{
+			Write<uint32_t>(static_cast<uint32_t>(s.size()));
+			m_Data.append(s);
+		}
+
+	public:
+		explicit GameObjectSnapshotWriter(std::string& data) : m_Data(data) {}
+	};
+
+	class GameObjectSnapshotReader
+	{
+	private:
+		std::string_view m_Data;
+
+	public:
+		// 数据不足时返回 false，之后不应继续读取
+		template<typename T>
+		bool Read(T& v)
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			if (m_Data.size() < sizeof(T))
+				return false;
+			std::memcpy(&v, m_Data.data(), sizeof(T));
+			m_Data.remove_prefix(sizeof(T));
+			return true;
+		}
+		// bool 只接受 0 和 1，其他字节直接复制到 bool 中是未定义行为
+		bool Read(bool& v)
+		{
+			static_assert(sizeof(bool) == 1);
+			uint8_t u = 0;
+			if (!Read(u) || u > 1)
+				return false;
+			v = (u != 0);
+			return true;
+		}
+		// 含有 bool 成员的结构体，bool_offsets 为这些成员的 offsetof，先检查再复制
+		template<typename T>
+		bool Read(T& v, std::initializer_list<size_t> bool_offsets)
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			if (m_Data.size() < sizeof(T))
+				return false;
+			for (size_t const offset : bool_offsets)
+			{
+				if (static_cast<unsigned char>(m_Data[offset]) > 1)
+					return false;
+			}
+			std::memcpy(&v, m_Data.data(), sizeof(T));
+			m_Data.remove_prefix(sizeof(T));
+			return true;
+		}
+		// 枚举按底层类型读取，只接受 [first, last] 范围内的值
+		template<typename E>
+		bool ReadEnum(E& v, E first, E last)
+		{
+			static_assert(std::is_enum_v<E>);
+			using U = std::underlying_type_t<E>;
+			U u{};
+			if (!Read(u) || u < static_cast<U>(first) || u > static_cast<U>(last))
+				return false;
+			v = static_cast<E>(u);
+			return true;
+		}
+		bool ReadString(std::string& s)
+		{
+			uint32_t size = 0;
+			if (!Read(size) || m_Data.size() < size)
+				return false;
+			s.assign(m_Data.data(), size);
+			m_Data.remove_prefix(size);
+			return true;
+		}
+		bool IsEnd() const noexcept { return m_Data.empty(); }
+
+	public:
+		explicit GameObjectSnapshotReader(std::string_view const& data) : m_Data(data) {}
+	};
+}
@@ -0,0 +1,183 @@
+﻿#include "GameObject/GameObjectSpatialGrid.hpp"
+
+namespace LuaSTGPlus
+{
+	static inline int32_t _ClampCell(float v, int32_t n) noexcept
+	{
+		// 注意 NaN 和超大值，先在浮点数上钳制再转换
+		if (!(v >= 0.0f))
+			return 0;
+		if (v >= (float)(n - 1))
+			return n - 1;
+		return (int32_t)v;
+	}
+
+	void GameObjectSpatialGrid::Clear() noexcept
+	{
+		m_Objects.clear();
+		m_Ranges.clear();
+		m_CellStart.clear();
+		m_CellItems.clear();
+		m_Overflow.clear();
+		m_Width = 0;
+		m_Height = 0;
+		m_Built = false;
+		m_Generation += 1;
+	}
+
+	void GameObjectSpatialGrid::Build(GameObject* first, GameObject* last, float cell_size, uint64_t version)
+	{
+		m_Objects.clear();
+		m_Ranges.clear();
+		m_Overflow.clear();
+		m_Version = version;
+		m_Generation += 1;
+		m_Built = true;
+
+		// 收集对象并计算整体范围
+
+		float min_x = std::numeric_limits<float>::infinity();
+		float min_y = std::numeric_limits<float>::infinity();
+		float max_x = -std::numeric_limits<float>::infinity();
+		float max_y = -std::numeric_limits<float>::infinity();
+		for (GameObject* p = first; p != last; p = p->pColliNext)
+		{
+			m_Objects.push_back(p);
+			if (_HasRegularBound(p))
+			{
+				float l, r, b, t;
+				p->GetColliderBound(l, r, b, t);
+				min_x = std::min(min_x, l);
+				max_x = std::max(max_x, r);
+				min_y = std::min(min_y, b);
+				max_y = std::max(max_y, t);
+			}
+		}
+
+		size_t const n = m_Objects.size();
+		m_Ranges.resize(n);
+
+		// 确定网格尺寸
+
+		float const extent_x = max_x - min_x;
+		float const extent_y = max_y - min_y;
+		if (!(min_x <= max_x) || !std::isfinite(extent_x) || !std::isfinite(extent_y))
+		{
+			// 没有可放入网格的对象，全部进入溢出表
+			m_Width = 0;
+			m_Height = 0;
+			m_CellStart.assign(1, 0);
+			m_CellItems.clear();
+			for (uint32_t i = 0; i < (uint32_t)n; i += 1)
+			{
+				m_Overflow.push_back(i);
+			}
+			return;
+		}
+		m_CellSize = std::max(cell_size, 1.0f);
+		m_CellSize = std::max(m_CellSize, extent_x / (float)MAX_GRID_SIZE);
+		m_CellSize = std::max(m_CellSize, extent_y / (float)MAX_GRID_SIZE);
+		m_OriginX = min_x;
+		m_OriginY = min_y;
+		m_MaxX = max_x;
+		m_MaxY = max_y;
+		m_Width = std::clamp((int32_t)(extent_x / m_CellSize) + 1, 1, MAX_GRID_SIZE);
+		m_Height = std::clamp((int32_t)(extent_y / m_CellSize) + 1, 1, MAX_GRID_SIZE);
+
+		// 计数
+
+		size_t const cell_count = (size_t)m_Width * (size_t)m_Height;
+		m_CellStart.assign(cell_count + 1, 0);
+		for (uint32_t i = 0; i < (uint32_t)n; i += 1)
+		{
+			GameObject const* p = m_Objects[i];
+			CellRange& range = m_Ranges[i];
+			if (!_HasRegularBound(p))
+			{
+				range = { 1, 1, 0, 0 };
+				m_Overflow.push_back(i);
+				continue;
+			}
+			float l, r, b, t;
+			p->GetColliderBound(l, r, b, t);
+			range.x0 = _ClampCell(std::floor((l - m_OriginX) / m_CellSize), m_Width);
+			range.x1 = _ClampCell(std::floor((r - m_OriginX) / m_CellSize), m_Width);
+			range.y0 = _ClampCell(std::floor((b - m_OriginY) / m_CellSize), m_Height);
+			range.y1 = _ClampCell(std::floor((t - m_OriginY) / m_CellSize), m_Height);
+			if ((range.x1 - range.x0 + 1) * (range.y1 - range.y0 + 1) > MAX_CELLS_PER_OBJECT)
+			{
+				range = { 1, 1, 0, 0 };
+				m_Overflow.push_back(i);
+				continue;
+			}
+			for (int32_t cy = range.y0; cy <= range.y1; cy += 1)
+			{
+				for (int32_t cx = range.x0; cx <= range.x1; cx += 1)
+				{
+					m_CellStart[(size_t)cy * (size_t)m_Width + (size_t)cx + 1] += 1;
+				}
+			}
+		}
+		for (size_t c = 0; c < cell_count; c += 1)
+		{
+			m_CellStart[c + 1] += m_CellStart[c];
+		}
+
+		// 填充，按对象序号顺序写入，因此每个格子内的序号是升序的
+
+		m_CellItems.resize(m_CellStart[cell_count]);
+		std::vector<uint32_t> cursor(m_CellStart.begin(), m_CellStart.end() - 1);
+		for (uint32_t i = 0; i < (uint32_t)n; i += 1)
+		{
+			CellRange const& range = m_Ranges[i];
+			for (int32_t cy = range.y0; cy <= range.y1; cy += 1)
+			{
+				for (int32_t cx = range.x0; cx <= range.x1; cx += 1)
+				{
+					m_CellItems[cursor[(size_t)cy * (size_t)m_Width + (size_t)cx]++] = i;
+				}
+			}
+		}
+	}
+
+	void GameObjectSpatialGrid::Query(GameObject const* p, std::vector<uint32_t>& out) const
+	{
+		if (!_HasRegularBound(p))
+		{
+			// 无法确定范围，保守地返回所有对象
+			out.resize(m_Objects.size());
+			for (uint32_t i = 0; i < (uint32_t)out.size(); i += 1)
+			{
+				out[i] = i;
+			}
+			return;
+		}
+		float l, r, b, t;
+		p->GetColliderBound(l, r, b, t);
+		QueryRect(l, r, b, t, out);
+	}
+
+	void GameObjectSpatialGrid::QueryRect(float l, float r, float b, float t, std::vector<uint32_t>& out) const
+	{
+		out.clear();
+		if (m_Width > 0 && m_Height > 0 && !(r < m_OriginX || l > m_MaxX || t < m_OriginY || b > m_MaxY))
+		{
+			int32_t const x0 = _ClampCell(std::floor((l - m_OriginX) / m_CellSize), m_Width);
+			int32_t const x1 = _ClampCell(std::floor((r - m_OriginX) / m_CellSize), m_Width);
+			int32_t const y0 = _ClampCell(std::floor((b - m_OriginY) / m_CellSize), m_Height);
+			int32_t const y1 = _ClampCell(std::floor((t - m_OriginY) / m_CellSize), m_Height);
+			for (int32_t cy = y0; cy <= y1; cy += 1)
+			{
+				for (int32_t cx = x0; cx <= x1; cx += 1)
+				{
+					size_t const c = (size_t)cy * (size_t)m_Width + (size_t)cx;
+					out.insert(out.end(), m_CellItems.begin() + m_CellStart[c], m_CellItems.begin() + m_CellStart[c + 1]);
+				}
+			}
+		}
+		out.insert(out.end(), m_Overflow.begin(), m_Overflow.end());
+		// 跨越多个格子的对象会重复出现
+		std::sort(out.begin(), out.end());
+		out.erase(std::unique(out.begin(), out.end()), out.end());
+	}
+}
@@ -0,0 +1,68 @@
+﻿#pragma once
+#include "GameObject/GameObject.hpp"
+
+namespace LuaSTGPlus
+{
+	// 碰撞检测宽相位：均匀网格
+	// 按链表顺序记录对象，查询结果为升序的对象序号，即原链表顺序
+	// 构建后查询不修改网格，可以在多个线程上同时查询
+	class GameObjectSpatialGrid
+	{
+	public:
+		static constexpr int32_t MAX_GRID_SIZE = 256;      // 单轴最大格子数
+		static constexpr int32_t MAX_CELLS_PER_OBJECT = 16; // 超过此格子数的对象放入溢出表，每次查询都作为候选
+
+	private:
+		struct CellRange
+		{
+			int32_t x0, y0, x1, y1;
+		};
+
+		std::vector<GameObject*> m_Objects;     // 建立时的对象，按链表顺序
+		std::vector<CellRange> m_Ranges;        // 对象覆盖的格子范围，x0 > x1 表示在溢出表中
+		std::vector<uint32_t> m_CellStart;      // 每个格子在 m_CellItems 中的起始位置，长度为格子数 + 1
+		std::vector<uint32_t> m_CellItems;      // 格子内的对象序号
+		std::vector<uint32_t> m_Overflow;       // 溢出表（半径过大、半径为负、坐标非有限值）
+		float m_CellSize{ 64.0f };
+		float m_OriginX{ 0.0f };
+		float m_OriginY{ 0.0f };
+		float m_MaxX{ 0.0f };
+		float m_MaxY{ 0.0f };
+		int32_t m_Width{ 0 };
+		int32_t m_Height{ 0 };
+		uint64_t m_Version{ 0 };
+		uint64_t m_Generation{ 0 };             // 每次构建或清空时递增，持有对象序号的调用方用来检查网格是否已重建
+		bool m_Built{ false };
+
+		static inline bool _HasRegularBound(GameObject const* p) noexcept
+		{
+			return std::isfinite(p->x) && std::isfinite(p->y) && std::isfinite(p->col_r) && p->col_r >= 0.0f
+				&& (!p->IsSweeping() || (std::isfinite(p->lastx) && std::isfinite(p->lasty)));
+		}
+
+	public:
+		/// @brief 从碰撞链表构建网格
+		/// @param first 链表第一个对象
+		/// @param last 链表尾哨兵
+		/// @param cell_size 期望的格子大小，实际大小可能因为格子数限制而变大
+		/// @param version 构建时对应的碰撞组版本
+		void Build(GameObject* first, GameObject* last, float cell_size, uint64_t version);
+
+		/// @brief 查询外接矩形可能与指定对象外接矩形相交的对象
+		/// @note 连续碰撞检测的对象使用整个扫过范围的外接矩形，建立网格时也一样
+		/// @param p 查询对象
+		/// @param out 输出升序排列的对象序号（会先清空）
+		void Query(GameObject const* p, std::vector<uint32_t>& out) const;
+
+		/// @brief 查询外接矩形可能与指定矩形相交的对象
+		/// @param out 输出升序排列的对象序号（会先清空）
+		void QueryRect(float l, float r, float b, float t, std::vector<uint32_t>& out) const;
+
+		void Clear() noexcept;
+		bool IsBuilt() const noexcept { return m_Built; }
+		uint64_t GetVersion() const noexcept { return m_Version; }
+		uint64_t GetGeneration() const noexcept { return m_Generation; }
+		size_t GetObjectCount() const noexcept { return m_Objects.size(); }
+		GameObject* GetObject(uint32_t i) const noexcept { return m_Objects[i]; }
+	};
+}
@@ -1,4 +1,5 @@
 #include "GameResource/Implement/ResourceParticleImpl.hpp"
+#include "GameObject/GameObjectSnapshot.hpp"
 
 namespace LuaSTGPlus
 {
@@ -286,4 +287,84 @@ namespace LuaSTGPlus
 				pInst.fSpin);
 		}
 	}
+	void ParticlePoolImpl::SaveState(std::string& out)
+	{
+		GameObjectSnapshotWriter w(out);
+		w.Write(m_Info.tParticleSystemInfo);
+		w.Write(m_Info.eBlendMode);
+		w.Write(m_Info.colVertexColor);
+		w.WriteString(m_Random.serialize());
+		w.Write(m_RandomSeed);
+		w.Write(m_iStatus);
+		w.Write(m_vCenter);
+		w.Write(m_vPrevCenter);
+		w.Write(m_fDirection);
+		w.Write(m_fAge);
+		w.Write(m_fEmissionResidue);
+		w.Write(m_bOldBehavior);
+		w.Write(m_iAlive);
+		for (size_t i = 0; i < m_iAlive; i += 1)
+		{
+			w.Write(m_ParticlePool[i]);
+		}
+	}
+	bool ParticlePoolImpl::LoadState(std::string_view const& data)
+	{
+		// 先读到临时变量，数据无效时不修改粒子池
+		GameObjectSnapshotReader r(data);
+		hgeParticleSystemInfo info{};
+		BlendMode blend = BlendMode::MulAlpha;
+		float color[4]{};
+		std::string random_state;
+		UtilRandom::xoshiro128p random = m_Random;
+		uint32_t seed = 0;
+		Status status = Status::Alive;
+		Core::Vector2F center, prev_center;
+		float direction = 0.0f, age = 0.0f, residue = 0.0f;
+		bool old_behavior = true;
+		size_t alive = 0;
+		bool ok = r.Read(info, { offsetof(hgeParticleSystemInfo, bRelative) })
+			&& r.ReadEnum(blend, BlendMode::MulAlpha, BlendMode::HueScreen)
+			&& r.Read(color)
+			&& r.ReadString(random_state) && random.deserialize(random_state)
+			&& r.Read(seed)
+			&& r.ReadEnum(status, Status::Alive, Status::Sleep)
+			&& r.Read(center)
+			&& r.Read(prev_center)
+			&& r.Read(direction)
+			&& r.Read(age)
+			&& r.Read(residue)
+			&& r.Read(old_behavior)
+			&& r.Read(alive) && alive <= LPARTICLE_MAXCNT;
+		std::vector<hgeParticle> particles;
+		if (ok)
+		{
+			particles.resize(alive);
+			for (auto& p : particles)
+			{
+				ok = r.Read(p);
+				if (!ok)
+					break;
+			}
+		}
+		if (!ok || !r.IsEnd())
+		{
+			return false;
+		}
+		m_Info.tParticleSystemInfo = info;
+		m_Info.eBlendMode = blend;
+		std::memcpy(m_Info.colVertexColor, color, sizeof(color));
+		m_Random = random;
+		m_RandomSeed = seed;
+		m_iStatus = status;
+		m_vCenter = center;
+		m_vPrevCenter = prev_center;
+		m_fDirection = direction;
+		m_fAge = age;
+		m_fEmissionResidue = residue;
+		m_bOldBehavior = old_behavior;
+		std::copy(particles.begin(), particles.end(), m_ParticlePool.begin());
+		m_iAlive = alive;
+		return true;
+	}
 }
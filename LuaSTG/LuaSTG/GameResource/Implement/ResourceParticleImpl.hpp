@@ -89,6 +89,8 @@ namespace LuaSTGPlus
 		void Update(float delta);
 		void Render(float scaleX, float scaleY);
 		void SetOldBehavior(bool b) { m_bOldBehavior = b; }
+		void SaveState(std::string& out);
+		bool LoadState(std::string_view const& data);
 	public:
 		ParticlePoolImpl(Core::ScopeObject<IResourceParticle> ps_ref);
 	};
@@ -66,6 +66,9 @@ namespace LuaSTGPlus
 		virtual void Update(float delta) = 0;
 		virtual void Render(float scaleX, float scaleY) = 0;
 		virtual void SetOldBehavior(bool b) = 0;
+		// 保存和恢复粒子池的全部运行状态，用于对象池快照
+		virtual void SaveState(std::string& out) = 0;
+		virtual bool LoadState(std::string_view const& data) = 0;
 	};
 
 	struct IResourceParticle : public IResourceBase
@@ -236,6 +236,25 @@ namespace LuaSTGPlus
                     return 4;
                 }
 
+                static int Snapshot(lua_State* L)
+                {
+                    GETUDATA(p, 1);
+                    CHECKUDATA(p);
+                    std::string data;
+                    p->handle->SaveState(data);
+                    lua_pushlstring(L, data.data(), data.size());
+                    return 1;
+                }
+                static int Restore(lua_State* L)
+                {
+                    GETUDATA(p, 1);
+                    CHECKUDATA(p);
+                    size_t size = 0;
+                    char const* data = luaL_checklstring(L, 2, &size);
+                    lua_pushboolean(L, p->handle->LoadState(std::string_view(data, size)));
+                    return 1;
+                }
+
                 static int Meta_Len(lua_State* L)
                 {
                     GETUDATA(p, 1);
@@ -280,6 +299,8 @@ namespace LuaSTGPlus
                 { "SetAllWidth", &Function::SetAllWidth },
                 { "SetEnvelope", &Function::SetEnvelope },
                 { "GetEnvelope", &Function::GetEnvelope },
+                { "Snapshot", &Function::Snapshot },
+                { "Restore", &Function::Restore },
                 { NULL, NULL }
             };
 
@@ -16,6 +16,36 @@ void LuaSTGPlus::LuaWrapper::GameObjectManagerWrapper::Register(lua_State* L) no
 			lua_pushinteger(L, (lua_Integer)LPOOL.GetObjectCount());
 			return 1;
 		}
+		static int GetObjectPoolCapacity(lua_State* L) noexcept
+		{
+			lua_pushinteger(L, (lua_Integer)LPOOL.GetObjectCapacity());
+			lua_pushinteger(L, (lua_Integer)LPOOL.GetObjectReserved());
+			return 2;
+		}
+		static int CompactObjectPool(lua_State* L)
+		{
+			return LPOOL.CompactPool(L);
+		}
+		static int SetRenderCulling(lua_State* L)
+		{
+			LPOOL.SetRenderCulling(lua_toboolean(L, 1), (float)luaL_optnumber(L, 2, 32.0));
+			return 0;
+		}
+		static int SetRenderCullRect(lua_State* L)
+		{
+			if (lua_gettop(L) == 0)
+			{
+				LPOOL.ResetRenderCullRect();
+				return 0;
+			}
+			LPOOL.SetRenderCullRect(
+				(float)luaL_checknumber(L, 1),
+				(float)luaL_checknumber(L, 2),
+				(float)luaL_checknumber(L, 3),
+				(float)luaL_checknumber(L, 4)
+			);
+			return 0;
+		}
 		static int ObjFrame(lua_State* L)
 		{
 			if (!LPOOL.CheckIsMainThread(L))
@@ -23,6 +53,12 @@ void LuaSTGPlus::LuaWrapper::GameObjectManagerWrapper::Register(lua_State* L) no
 			LPOOL.DoFrame();
 			return 0;
 		}
+		static int ObjStep(lua_State* L)
+		{
+			if (!LPOOL.CheckIsMainThread(L))
+				luaL_error(L, "ObjStep was called in coroutine, which is disallowed");
+			return LPOOL.Step(L, lua_toboolean(L, 1));
+		}
 		static int ObjRender(lua_State* L)
 		{
 			if (!LPOOL.CheckIsMainThread(L))
@@ -54,6 +90,215 @@ void LuaSTGPlus::LuaWrapper::GameObjectManagerWrapper::Register(lua_State* L) no
 			LPOOL.CollisionCheck(luaL_checkinteger(L, 1), luaL_checkinteger(L, 2));
 			return 0;
 		}
+		static int SetCollisionPairs(lua_State* L)
+		{
+			// { { groupA, groupB [, world] }, ... }
+			std::vector<GameObjectPool::CollisionPair> pairs;
+			if (!lua_isnoneornil(L, 1))
+			{
+				luaL_checktype(L, 1, LUA_TTABLE);
+				int const n = (int)lua_objlen(L, 1);
+				pairs.reserve((size_t)n);
+				for (int i = 1; i <= n; i += 1)
+				{
+					lua_rawgeti(L, 1, i);		// t pair
+					if (!lua_istable(L, -1))
+						return luaL_error(L, "invalid collision pair at index %d.", i);
+					lua_rawgeti(L, -1, 1);		// t pair a
+					lua_rawgeti(L, -2, 2);		// t pair a b
+					lua_rawgeti(L, -3, 3);		// t pair a b world
+					if (!lua_isnumber(L, -3) || !lua_isnumber(L, -2))
+						return luaL_error(L, "invalid collision pair at index %d.", i);
+					pairs.push_back(GameObjectPool::CollisionPair{
+						(size_t)lua_tointeger(L, -3),
+						(size_t)lua_tointeger(L, -2),
+						lua_isnumber(L, -1) ? lua_tointeger(L, -1) : 0,
+						lua_isnumber(L, -1) != 0,
+					});
+					lua_pop(L, 4);				// t
+				}
+			}
+			LPOOL.SetCollisionPairs(pairs);
+			return 0;
+		}
+		static int CollisionCheckAll(lua_State* L)
+		{
+			if (!LPOOL.CheckIsMainThread(L))
+				luaL_error(L, "CollisionCheckAll was called in coroutine, which is disallowed");
+			LPOOL.CollisionCheckAll();
+			return 0;
+		}
+		static int SetCollisionBroadphase(lua_State* L)
+		{
+			LPOOL.SetCollisionBroadphase(lua_toboolean(L, 1), (float)luaL_optnumber(L, 2, 64.0));
+			return 0;
+		}
+		static int InvalidateCollisionGroup(lua_State* L)
+		{
+			LPOOL.InvalidateCollisionGroup(luaL_optinteger(L, 1, -1));
+			return 0;
+		}
+		static int SetCollisionBatchDispatch(lua_State* L)
+		{
+			LPOOL.SetCollisionBatchDispatch(lua_toboolean(L, 1));
+			return 0;
+		}
+		static int SetCollisionWorkerCount(lua_State* L)
+		{
+			lua_Integer const count = luaL_checkinteger(L, 1);
+			if (count < 0 || count > 64)
+				return luaL_error(L, "invalid worker count %d.", (int)count);
+			LPOOL.SetCollisionWorkerCount((size_t)count);
+			return 0;
+		}
+		static int CollisionCheckList(lua_State* L)
+		{
+			return LPOOL.CollisionCheckList(L, (size_t)luaL_checkinteger(L, 1), (size_t)luaL_checkinteger(L, 2));
+		}
+		// 空间查询的边界和距离不能是 NaN，否则矩形无法比较；圆心必须是有限值，否则与无穷大的半径相减得到 NaN
+		static float CheckQueryBound(lua_State* L, int idx)
+		{
+			lua_Number const v = luaL_checknumber(L, idx);
+			luaL_argcheck(L, !std::isnan(v), idx, "number expected, got NaN");
+			return (float)v;
+		}
+		static float CheckQueryCenter(lua_State* L, int idx)
+		{
+			float const v = (float)luaL_checknumber(L, idx);
+			luaL_argcheck(L, std::isfinite(v), idx, "finite number expected");
+			return v;
+		}
+		static float CheckQueryDistance(lua_State* L, int idx)
+		{
+			float const v = CheckQueryBound(L, idx);
+			luaL_argcheck(L, v >= 0.0f, idx, "distance must not be negative");
+			return v;
+		}
+		static int QueryCircle(lua_State* L)
+		{
+			// group, x, y, r [, sorted] [, callback]
+			int const callback_idx = lua_isfunction(L, 6) ? 6 : 0;
+			return LPOOL.QueryCircle(L,
+				luaL_checkinteger(L, 1),
+				CheckQueryCenter(L, 2),
+				CheckQueryCenter(L, 3),
+				CheckQueryDistance(L, 4),
+				lua_toboolean(L, 5),
+				callback_idx);
+		}
+		static int QueryRect(lua_State* L)
+		{
+			// group, l, r, b, t [, callback]，左右、上下颠倒时交换
+			int const callback_idx = lua_isfunction(L, 6) ? 6 : 0;
+			float l = CheckQueryBound(L, 2);
+			float r = CheckQueryBound(L, 3);
+			float b = CheckQueryBound(L, 4);
+			float t = CheckQueryBound(L, 5);
+			if (l > r)
+				std::swap(l, r);
+			if (b > t)
+				std::swap(b, t);
+			return LPOOL.QueryRect(L, luaL_checkinteger(L, 1), l, r, b, t, callback_idx);
+		}
+		static int QueryNearest(lua_State* L)
+		{
+			// group, x, y [, max_dist]，省略 max_dist 时遍历整个碰撞组，不使用网格
+			return LPOOL.QueryNearest(L,
+				luaL_checkinteger(L, 1),
+				CheckQueryCenter(L, 2),
+				CheckQueryCenter(L, 3),
+				lua_isnoneornil(L, 4) ? std::numeric_limits<float>::infinity() : CheckQueryDistance(L, 4));
+		}
+		static int NewEmitter(lua_State* L)
+		{
+			return LPOOL.NewEmitter(L);
+		}
+		static int DelEmitter(lua_State* L)
+		{
+			lua_pushboolean(L, LPOOL.DelEmitter(L, (uint64_t)luaL_checkinteger(L, 1)));
+			return 1;
+		}
+		static int SetEmitterActive(lua_State* L)
+		{
+			lua_pushboolean(L, LPOOL.SetEmitterActive((uint64_t)luaL_checkinteger(L, 1), lua_toboolean(L, 2)));
+			return 1;
+		}
+		static int SetEmitterPosition(lua_State* L)
+		{
+			lua_pushboolean(L, LPOOL.SetEmitterPosition(
+				(uint64_t)luaL_checkinteger(L, 1),
+				(float)luaL_checknumber(L, 2),
+				(float)luaL_checknumber(L, 3)
+			));
+			return 1;
+		}
+		static int IsEmitterValid(lua_State* L)
+		{
+			lua_pushboolean(L, LPOOL.IsEmitterValid((uint64_t)luaL_checkinteger(L, 1)));
+			return 1;
+		}
+		static int NewMotion(lua_State* L)
+		{
+			return LPOOL.NewMotion(L);
+		}
+		static int DelMotion(lua_State* L)
+		{
+			lua_Integer const motion = luaL_checkinteger(L, 1);
+			if (motion <= 0 || motion > (lua_Integer)UINT32_MAX || !LPOOL.DelMotion((uint32_t)motion))
+				return luaL_error(L, "invalid motion program %lld.", (long long)motion);
+			return 0;
+		}
+		static int SetMotion(lua_State* L)
+		{
+			GameObject* p = LPOOL.CastGameObject(L, 1);
+			lua_Integer const motion = lua_isnoneornil(L, 2) ? 0 : luaL_checkinteger(L, 2);
+			if (motion < 0 || motion > (lua_Integer)UINT32_MAX || !LPOOL.SetMotion(p, (uint32_t)motion))
+				return luaL_error(L, "invalid motion program %lld.", (long long)motion);
+			return 0;
+		}
+		static int ObjSnapshot(lua_State* L)
+		{
+			return LPOOL.Snapshot(L);
+		}
+		static int ObjRestore(lua_State* L)
+		{
+			return LPOOL.Restore(L);
+		}
+		static int SetAttrs(lua_State* L)
+		{
+			return LPOOL.SetAttrs(L);
+		}
+		static int AttrSetter(lua_State* L)
+		{
+			return LPOOL.NewAttrSetter(L);
+		}
+		static int ForEachInGroup(lua_State* L)
+		{
+			return LPOOL.ForEachInGroup(L);
+		}
+		static int GetObjectViewDeclaration(lua_State* L)
+		{
+			std::string const& decl = GameObject::GetViewDeclaration();
+			lua_pushlstring(L, decl.data(), decl.size());
+			return 1;
+		}
+		static int SetObjectTableRecycling(lua_State* L)
+		{
+			lua_Integer const max_count = luaL_optinteger(L, 2, (lua_Integer)LPOOL.GetObjectCapacity());
+			if (max_count < 0)
+				return luaL_error(L, "invalid argument #2, cache size must be non-negative.");
+			LPOOL.SetObjectTableRecycling(lua_toboolean(L, 1), (size_t)max_count);
+			return 0;
+		}
+		static int GetObjectTableRecyclingInfo(lua_State* L)
+		{
+			// 返回 cached, hits, misses, estimated_saved_bytes；最后一项是按固定的 table 大小估算的，不是实测值
+			return LPOOL.GetObjectTableRecyclingInfo(L);
+		}
+		static int RefreshClass(lua_State* L)
+		{
+			return LPOOL.RefreshClass(L);
+		}
 		static int UpdateXY(lua_State* L)
 		{
 			if (!LPOOL.CheckIsMainThread(L))
@@ -68,7 +313,7 @@ void LuaSTGPlus::LuaWrapper::GameObjectManagerWrapper::Register(lua_State* L) no
 			LPOOL.AfterFrame();
 			return 0;
 		}
-		static int ResetPool(lua_State* L) noexcept
+		static int ResetPool(lua_State* L)
 		{
 			std::ignore = L;
 			LPOOL.ResetPool();
@@ -142,19 +387,53 @@ void LuaSTGPlus::LuaWrapper::GameObjectManagerWrapper::Register(lua_State* L) no
 		{ "ObjTable", &Wrapper::ObjTable },
 		// 对象管理器
 		{ "GetnObj", &Wrapper::GetnObj },
+		{ "GetObjectPoolCapacity", &Wrapper::GetObjectPoolCapacity },
+		{ "CompactObjectPool", &Wrapper::CompactObjectPool },
+		{ "SetRenderCulling", &Wrapper::SetRenderCulling },
+		{ "SetRenderCullRect", &Wrapper::SetRenderCullRect },
 		{ "ObjFrame", &Wrapper::ObjFrame },
+		{ "ObjStep", &Wrapper::ObjStep },
 		{ "ObjRender", &Wrapper::ObjRender },
 		{ "BoundCheck", &Wrapper::BoundCheck },
 		{ "SetBound", &Wrapper::SetBound },
 		{ "CollisionCheck", &Wrapper::CollisionCheck },
+		{ "SetCollisionPairs", &Wrapper::SetCollisionPairs },
+		{ "CollisionCheckAll", &Wrapper::CollisionCheckAll },
+		{ "SetCollisionBroadphase", &Wrapper::SetCollisionBroadphase },
+		{ "InvalidateCollisionGroup", &Wrapper::InvalidateCollisionGroup },
+		{ "SetCollisionBatchDispatch", &Wrapper::SetCollisionBatchDispatch },
+		{ "SetCollisionWorkerCount", &Wrapper::SetCollisionWorkerCount },
+		{ "CollisionCheckList", &Wrapper::CollisionCheckList },
+		{ "QueryCircle", &Wrapper::QueryCircle },
+		{ "QueryRect", &Wrapper::QueryRect },
+		{ "QueryNearest", &Wrapper::QueryNearest },
+		{ "NewEmitter", &Wrapper::NewEmitter },
+		{ "DelEmitter", &Wrapper::DelEmitter },
+		{ "SetEmitterActive", &Wrapper::SetEmitterActive },
+		{ "SetEmitterPosition", &Wrapper::SetEmitterPosition },
+		{ "IsEmitterValid", &Wrapper::IsEmitterValid },
+		{ "NewMotion", &Wrapper::NewMotion },
+		{ "DelMotion", &Wrapper::DelMotion },
+		{ "SetMotion", &Wrapper::SetMotion },
+		{ "ObjSnapshot", &Wrapper::ObjSnapshot },
+		{ "ObjRestore", &Wrapper::ObjRestore },
+		{ "GetObjectViewDeclaration", &Wrapper::GetObjectViewDeclaration },
+		{ "SetAttrs", &Wrapper::SetAttrs },
+		{ "AttrSetter", &Wrapper::AttrSetter },
+		{ "ForEachInGroup", &Wrapper::ForEachInGroup },
+		{ "SetObjectTableRecycling", &Wrapper::SetObjectTableRecycling },
+		{ "GetObjectTableRecyclingInfo", &Wrapper::GetObjectTableRecyclingInfo },
+		{ "RefreshClass", &Wrapper::RefreshClass },
 		{ "UpdateXY", &Wrapper::UpdateXY },
 		{ "AfterFrame", &Wrapper::AfterFrame },
 		{ "ResetPool", &Wrapper::ResetPool },
 		// 对象遍历
 		{ "NextObject", &GameObjectPool::api_NextObject },
 		{ "ObjList", &GameObjectPool::api_ObjList },
+		{ "ObjWalk", &GameObjectPool::api_ObjWalk },
 		// 对象控制函数
 		{ "New", &GameObjectPool::api_New },
+		{ "NewBatch", &GameObjectPool::api_NewBatch },
 		{ "ResetObject", &GameObjectPool::api_ResetObject },
 		{ "Del", &GameObjectPool::api_Del },
 		{ "Kill", &GameObjectPool::api_Kill },
@@ -68,6 +68,14 @@ void LuaSTGPlus::BuiltInFunctionWrapper::Register(lua_State* L)noexcept
 			);
 			return 0;
 		}
+		static int SetObjectPoolCapacity(lua_State* L)
+		{
+			lua_Integer const v = luaL_checkinteger(L, 1);
+			if (v <= 0)
+				return luaL_error(L, "invalid argument #1, object pool capacity must be positive.");
+			LAPP.SetObjectPoolCapacity((uint32_t)std::min<lua_Integer>(v, LOBJPOOL_SIZE_MAX));
+			return 0;
+		}
 		static int SetFPS(lua_State* L)
 		{
 			int v = luaL_checkinteger(L, 1);
@@ -81,6 +89,11 @@ void LuaSTGPlus::BuiltInFunctionWrapper::Register(lua_State* L)noexcept
 			lua_pushnumber(L, LAPP.GetFPS());
 			return 1;
 		}
+		static int IsHeadless(lua_State* L)noexcept
+		{
+			lua_pushboolean(L, LAPP.IsHeadless());
+			return 1;
+		}
 		static int Log(lua_State* L)
 		{
 			lua_Integer const level = luaL_checkinteger(L, 1);
@@ -256,8 +269,10 @@ void LuaSTGPlus::BuiltInFunctionWrapper::Register(lua_State* L)noexcept
 		{ "SetWindowed", &WrapperImplement::SetWindowed },
 		{ "SetFPS", &WrapperImplement::SetFPS },
 		{ "GetFPS", &WrapperImplement::GetFPS },
+		{ "IsHeadless", &WrapperImplement::IsHeadless },
 		{ "SetVsync", &WrapperImplement::SetVsync },
 		{ "SetResolution", &WrapperImplement::SetResolution },
+		{ "SetObjectPoolCapacity", &WrapperImplement::SetObjectPoolCapacity },
 		{ "Log", &WrapperImplement::Log },
 		{ "DoFile", &WrapperImplement::DoFile },
 		{ "LoadTextFile", &WrapperImplement::LoadTextFile },
@@ -284,6 +284,7 @@ static int lib_setOrtho(lua_State* L)
         );
     }
     LR2D()->setOrtho(box);
+    LPOOL.SetRenderCullOrtho(box.a.x, box.b.x, box.b.y, box.a.y);
     return 0;
 }
 static int lib_setPerspective(lua_State* L)
@@ -310,6 +311,7 @@ static int lib_setPerspective(lua_State* L)
         (float)luaL_checknumber(L, 11),
         zrange.x,
         zrange.y);
+    LPOOL.ResetRenderCullOrtho();
     return 0;
 }
 
@@ -99,6 +99,46 @@ function lstg.acos(x) return deg(acos(x)) end
 function lstg.atan(...) return deg(atan(...)) end
 function lstg.atan2(y, x) return deg(atan2(y, x)) end
 
+-- 对象视图，通过 FFI 直接读写对象的常用字段，不经过 __index、__newindex；rot、omega 为弧度制
+-- 视图指向对象池中的槽位而不是对象：对象被回收后槽位会被之后创建的对象复用，
+-- lstg.CompactObjectPool 也会把对象移到其他槽位，此后视图读写的是槽位上的其他对象；
+-- lstg.ObjView 同时返回对象的 uid，使用保存下来的视图前用 lstg.IsObjViewValid 检查；
+-- uid 是对象 table 第 5 个槽位上的标记，也可以传给 lstg.IsValid(obj, uid) 检查回收复用的对象 table
+-- 通过视图修改坐标不会使碰撞检测和空间查询的网格失效，之后还要在同一帧内检测或查询时调用 lstg.InvalidateCollisionGroup
+-- 通过视图修改坐标也不算瞬移：开启 swept 的对象仍然检测从上一帧坐标扫过的范围；
+-- 而通过 self.x、self.y、self.vpos 赋值会被视为瞬移，这一帧不进行连续碰撞检测，需要连续碰撞检测的对象应当用 vx、vy 移动
+do
+    local ok, ffi = pcall(require, "ffi")
+    if ok then
+        ffi.cdef(lstg.GetObjectViewDeclaration())
+        local view_t = ffi.typeof("lstg_GameObjectView*")
+        local cast = ffi.cast
+        local rawget = rawget
+        local type = type
+        local error = error
+        function lstg.ObjView(obj)
+            local p = rawget(obj, 3)
+            if type(p) ~= "userdata" then
+                error("invalid lstg object for 'ObjView'.", 2)
+            end
+            local view = cast(view_t, p)
+            -- 对象被删除后第 3 个槽位是空指针
+            if view == nil then
+                error("invalid lstg object for 'ObjView', object has been deleted.", 2)
+            end
+            -- 对象 table 上的 uid 与槽位上的对象不一致时，table 已经被回收复用或者被脚本修改过
+            local uid = rawget(obj, 5)
+            if view.uid ~= uid then
+                error("invalid lstg object for 'ObjView', object table does not match the object.", 2)
+            end
+            return view, uid
+        end
+        function lstg.IsObjViewValid(view, uid)
+            return view.status ~= 0 and view.uid == uid
+        end
+    end
+end
+
 )";
 #pragma endregion
 
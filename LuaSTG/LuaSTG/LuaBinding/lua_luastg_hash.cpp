@@ -453,6 +453,24 @@ LuaSTG::GameObjectMember LuaSTG::MapGameObjectMember(const char* key) {
           break;
         case 'o':
           switch(key[2]) {
+            case 'c':
+              switch(key[3]) {
+                case 'u':
+                  switch(key[4]) {
+                    case 'l':
+                      switch(key[5]) {
+                        case 'l':
+                          switch(key[6]) {
+                            case '\0':
+                              return LuaSTG::GameObjectMember::NOCULL;
+                          }
+                          break;
+                      }
+                      break;
+                  }
+                  break;
+              }
+              break;
             case 'p':
               switch(key[3]) {
                 case 'a':
@@ -599,6 +617,24 @@ LuaSTG::GameObjectMember LuaSTG::MapGameObjectMember(const char* key) {
               break;
           }
           break;
+        case 'w':
+          switch(key[2]) {
+            case 'e':
+              switch(key[3]) {
+                case 'p':
+                  switch(key[4]) {
+                    case 't':
+                      switch(key[5]) {
+                        case '\0':
+                          return LuaSTG::GameObjectMember::SWEPT;
+                      }
+                      break;
+                  }
+                  break;
+              }
+              break;
+          }
+          break;
       }
       break;
     case 't':
@@ -41,21 +41,23 @@ namespace LuaSTG {
         MAXVX = 31,
         MAXVY = 32,
         NAVI = 33,
-        IGNORESUPERPAUSE = 34,
-        OMEGA = 35,
-        PAUSE = 36,
-        RES_RC = 37,
-        RECT = 38,
-        RESOLVEMOVE = 39,
-        ROT = 40,
-        STATUS = 41,
-        TIMER = 42,
-        VSCALE = 43,
-        VX = 44,
-        VY = 45,
-        WORLD = 46,
-        X = 47,
-        Y = 48,
+        NOCULL = 34,
+        IGNORESUPERPAUSE = 35,
+        OMEGA = 36,
+        PAUSE = 37,
+        RES_RC = 38,
+        RECT = 39,
+        RESOLVEMOVE = 40,
+        ROT = 41,
+        STATUS = 42,
+        SWEPT = 43,
+        TIMER = 44,
+        VSCALE = 45,
+        VX = 46,
+        VY = 47,
+        WORLD = 48,
+        X = 49,
+        Y = 50,
     };
     GameObjectMember MapGameObjectMember(const char* key);
 }
@@ -42,6 +42,12 @@ int main(int argc, char *argv[])
 			LAPP.Run();
 			result = EXIT_SUCCESS;
 		}
+		else if (LAPP.IsHeadless())
+		{
+			// 无窗口模式下不弹出对话框，避免阻塞自动化运行
+			std::fputs("Engine Initialization Failed! See engine.log for details.\n", stderr);
+			result = EXIT_FAILURE;
+		}
 		else
 		{
 			Platform::MessageBox::Error(LUASTG_INFO,
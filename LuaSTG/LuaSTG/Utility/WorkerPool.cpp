@@ -0,0 +1,102 @@
+﻿#include "Utility/WorkerPool.hpp"
+
+namespace LuaSTGPlus
+{
+	void WorkerPool::_WorkerMain(uint64_t generation)
+	{
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_WakeUp.wait(lock, [&] { return m_Exit || m_Generation != generation; });
+				if (m_Exit)
+					return;
+				generation = m_Generation;
+			}
+			_RunTasks();
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_Working -= 1;
+				if (m_Working == 0)
+					m_Done.notify_one();
+			}
+		}
+	}
+	void WorkerPool::_RunTasks()
+	{
+		while (true)
+		{
+			size_t const i = m_NextTask.fetch_add(1, std::memory_order_relaxed);
+			if (i >= m_TaskCount)
+				break;
+			(*m_Task)(i);
+		}
+	}
+	void WorkerPool::_Stop()
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Exit = true;
+		}
+		m_WakeUp.notify_all();
+		for (auto& t : m_Threads)
+		{
+			t.join();
+		}
+		m_Threads.clear();
+		m_Exit = false;
+	}
+
+	void WorkerPool::SetThreadCount(size_t n)
+	{
+		if (n == m_Threads.size())
+			return;
+		_Stop();
+		// 新线程从当前代数开始等待，否则会把上一次 Run 的代数当成新任务
+		uint64_t generation = 0;
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			generation = m_Generation;
+		}
+		m_Threads.reserve(n);
+		for (size_t i = 0; i < n; i += 1)
+		{
+			m_Threads.emplace_back(&WorkerPool::_WorkerMain, this, generation);
+		}
+	}
+
+	void WorkerPool::Run(size_t task_count, std::function<void(size_t)> const& task)
+	{
+		if (task_count == 0)
+			return;
+		if (m_Threads.empty() || task_count == 1)
+		{
+			for (size_t i = 0; i < task_count; i += 1)
+			{
+				task(i);
+			}
+			return;
+		}
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Task = &task;
+			m_TaskCount = task_count;
+			m_NextTask.store(0, std::memory_order_relaxed);
+			m_Working = m_Threads.size();
+			m_Generation += 1;
+		}
+		m_WakeUp.notify_all();
+		_RunTasks();
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Done.wait(lock, [&] { return m_Working == 0; });
+			m_Task = nullptr;
+			m_TaskCount = 0;
+		}
+	}
+
+	WorkerPool::~WorkerPool()
+	{
+		_Stop();
+	}
+}
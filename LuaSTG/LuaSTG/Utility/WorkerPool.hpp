@@ -0,0 +1,49 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace LuaSTGPlus
+{
+	// 简单的工作线程池
+	// 调用 Run 的线程也会参与执行任务，Run 返回时所有任务都已完成
+	class WorkerPool
+	{
+	private:
+		std::vector<std::thread> m_Threads;
+		std::mutex m_Mutex;
+		std::condition_variable m_WakeUp;
+		std::condition_variable m_Done;
+		std::function<void(size_t)> const* m_Task{ nullptr };
+		size_t m_TaskCount{ 0 };
+		std::atomic<size_t> m_NextTask{ 0 };
+		size_t m_Working{ 0 };
+		uint64_t m_Generation{ 0 };
+		bool m_Exit{ false };
+
+		void _WorkerMain(uint64_t generation);
+		void _RunTasks();
+		void _Stop();
+
+	public:
+		/// @brief 设置工作线程数（不包括调用 Run 的线程），0 表示不使用工作线程
+		void SetThreadCount(size_t n);
+
+		size_t GetThreadCount() const noexcept { return m_Threads.size(); }
+
+		/// @brief 执行 task(0) 到 task(task_count - 1)，任务之间没有顺序保证
+		/// @note 任务不能抛出异常，也不能再次调用 Run
+		void Run(size_t task_count, std::function<void(size_t)> const& task);
+
+	public:
+		WorkerPool() = default;
+		WorkerPool(WorkerPool const&) = delete;
+		WorkerPool& operator=(WorkerPool const&) = delete;
+		~WorkerPool();
+	};
+}
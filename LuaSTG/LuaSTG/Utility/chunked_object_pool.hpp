@@ -0,0 +1,133 @@
+#pragma once
+#include <cstddef>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace cpp {
+    // 按块增长的对象池，容量在运行时确定
+    // 块一旦分配就不会释放或移动，已分配对象的地址在对象池的生命周期内保持不变
+    template<typename T, size_t ChunkSize>
+    class chunked_object_pool {
+        static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0, "ChunkSize must be power of 2");
+        static_assert(ChunkSize % 64 == 0, "ChunkSize must be multiple of 64");
+    private:
+        size_t _capacity = 0;
+        size_t _limit = 0; // 可分配的序号上限，min(已分配内存的对象数量, 容量)
+        size_t _size = 0;
+        size_t _hint = 0; // 第一个可能含有空闲位的字
+        std::vector<std::unique_ptr<T[]>> _chunks;
+        std::vector<uint64_t> _free; // 空闲位图，1 表示空闲
+    private:
+        inline void _break() {
+            (void) 0;
+        }
+
+        [[nodiscard]]
+        inline bool _is_used(size_t id) const noexcept {
+            return id < _limit && (_free[id / 64] & (uint64_t(1) << (id % 64))) == 0;
+        }
+
+        bool _grow() noexcept {
+            size_t const base = _chunks.size() * ChunkSize;
+            if (base >= _capacity) {
+                return false;
+            }
+            try {
+                _chunks.reserve(_chunks.size() + 1);
+                _free.reserve((base + ChunkSize) / 64);
+                _chunks.emplace_back(std::make_unique<T[]>(ChunkSize));
+            }
+            catch (std::bad_alloc const&) {
+                return false;
+            }
+            // 新块中超出容量的部分不参与分配
+            _limit = (base + ChunkSize < _capacity) ? (base + ChunkSize) : _capacity;
+            _free.resize((base + ChunkSize) / 64, 0);
+            for (size_t idx_ = base; idx_ < _limit; idx_++) {
+                _free[idx_ / 64] |= uint64_t(1) << (idx_ % 64);
+            }
+            return true;
+        }
+
+    public:
+        // 总是分配序号最小的空闲对象，让存活的对象尽量集中在内存的前部
+        bool alloc(size_t& id) noexcept {
+            while (true) {
+                for (size_t w = _hint; w < _free.size(); w++) {
+                    if (_free[w] != 0) {
+                        size_t const bit = static_cast<size_t>(std::countr_zero(_free[w]));
+                        _free[w] &= ~(uint64_t(1) << bit);
+                        _hint = w;
+                        _size++;
+                        id = w * 64 + bit;
+                        return true;
+                    }
+                }
+                _hint = _free.size();
+                if (!_grow()) {
+                    _break();
+                    id = static_cast<size_t>(-1);
+                    return false;
+                }
+            }
+        };
+
+        void free(size_t id) noexcept {
+            if (_is_used(id)) {
+                _free[id / 64] |= uint64_t(1) << (id % 64);
+                if (id / 64 < _hint) {
+                    _hint = id / 64;
+                }
+                _size--;
+            }
+            else {
+                _break();
+            }
+        };
+
+        T* object(size_t id) noexcept {
+            if (_is_used(id)) {
+                return &_chunks[id / ChunkSize][id % ChunkSize];
+            }
+            else {
+                return nullptr;
+            }
+        };
+
+        [[nodiscard]]
+        size_t size() const noexcept {
+            return _size;
+        };
+
+        [[nodiscard]]
+        size_t max_size() const noexcept {
+            return _capacity;
+        };
+
+        // 已分配内存的对象数量
+        [[nodiscard]]
+        size_t reserved_size() const noexcept {
+            return _chunks.size() * ChunkSize;
+        };
+
+        // 回收所有对象，已分配的块会保留下来继续使用
+        void clear() noexcept {
+            for (auto& v : _free) {
+                v = 0;
+            }
+            for (size_t idx_ = 0; idx_ < _limit; idx_++) {
+                _free[idx_ / 64] |= uint64_t(1) << (idx_ % 64);
+            }
+            _hint = 0;
+            _size = 0;
+        };
+    public:
+        explicit chunked_object_pool(size_t capacity) noexcept : _capacity(capacity) {
+        };
+
+        ~chunked_object_pool() noexcept = default;
+    };
+}
@@ -106,6 +106,7 @@ require("test_log")
 require("test_filesys")
 require("test_dwrite")
 require("test_colli")
+require("test_colli_broadphase")
 require("test_posteffect")
 require("test_blend_color_burn")
 require("test_monitor")
@@ -115,6 +116,10 @@ require("test_f2dfont")
 require("test_hgefont")
 require("test_ttf")
 require("test_object_resource")
+require("test_objview")
+require("test_compact_pool")
+require("test_snapshot")
+require("test_object_table_recycling")
 require("test_random")
 require("test_se")
 
@@ -0,0 +1,81 @@
+local test = require("test")
+
+local GROUP_A = 1
+local GROUP_B = 2
+
+local hits = {}
+
+local function empty() end
+
+local class_a = {
+    empty,
+    empty,
+    empty,
+    empty,
+    function(self, other)
+        table.insert(hits, other.tag)
+        -- 第一次碰撞时把自己瞬移到远处的 B 对象上
+        if not self.teleported then
+            self.teleported = true
+            self.x = 500
+            self.y = 500
+        end
+    end,
+    empty;
+    is_class = true,
+}
+
+local class_b = {
+    empty,
+    empty,
+    empty,
+    empty,
+    empty,
+    empty;
+    is_class = true,
+}
+
+---@param broadphase boolean
+---@return string
+local function run(broadphase)
+    lstg.ResetPool()
+    lstg.SetCollisionBroadphase(broadphase, 64)
+    hits = {}
+    local a = lstg.New(class_a)
+    a.group = GROUP_A
+    a.x, a.y = 0, 0
+    a.a, a.b = 8, 8
+    local b1 = lstg.New(class_b)
+    b1.group = GROUP_B
+    b1.tag = "b1"
+    b1.x, b1.y = 0, 0
+    b1.a, b1.b = 8, 8
+    local b2 = lstg.New(class_b)
+    b2.group = GROUP_B
+    b2.tag = "b2"
+    b2.x, b2.y = 500, 500
+    b2.a, b2.b = 8, 8
+    lstg.CollisionCheck(GROUP_A, GROUP_B)
+    lstg.ResetPool()
+    return table.concat(hits, ",")
+end
+
+---@class test.Module.CollisionBroadphase : test.Base
+local M = {}
+
+function M:onCreate()
+    -- 回调中移动 A 对象后，宽相位的候选对象不再可信，结果必须和逐对检测一致
+    local expected = run(false)
+    assert(expected == "b1,b2", expected)
+    local actual = run(true)
+    assert(actual == expected, actual)
+    lstg.SetCollisionBroadphase(false)
+    lstg.Print("test.Module.CollisionBroadphase: passed")
+end
+
+function M:onDestroy()
+    lstg.SetCollisionBroadphase(false)
+    lstg.ResetPool()
+end
+
+test.registerTest("test.Module.CollisionBroadphase", M)
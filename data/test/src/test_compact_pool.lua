@@ -0,0 +1,105 @@
+local test = require("test")
+
+local object_class = {
+    function() end,
+    function() end,
+    function() end,
+    function() end,
+    function() end,
+    function() end;
+    is_class = true,
+}
+
+---@param group integer
+---@return table[]
+local function collect(group)
+    local list = {}
+    for _, obj in lstg.ObjWalk(group) do
+        list[#list + 1] = obj
+    end
+    return list
+end
+
+---@class test.Module.CompactObjectPool : test.Base
+local M = {}
+
+function M:onCreate()
+    lstg.ResetPool()
+
+    local objects = {}
+    for i = 1, 16 do
+        local obj = lstg.New(object_class)
+        obj.x = i
+        obj.group = i % 3
+        objects[i] = obj
+    end
+
+    -- 删除一部分对象，留下不连续的空槽位
+    local deleted = {}
+    for _, i in ipairs({ 1, 4, 5, 9, 14 }) do
+        deleted[#deleted + 1] = objects[i]
+        lstg.Del(objects[i])
+    end
+    lstg.AfterFrame()
+
+    local before = collect(-1)
+    local before_group = {}
+    for group = 0, 2 do
+        before_group[group] = collect(group)
+    end
+    local xs = {}
+    for i, obj in ipairs(before) do
+        xs[i] = obj.x
+    end
+    local uids = {}
+    if lstg.ObjView then
+        for i, obj in ipairs(before) do
+            local _, uid = lstg.ObjView(obj)
+            uids[i] = uid
+        end
+    end
+    assert(#before == 11)
+    assert(lstg.GetnObj() == 11)
+
+    local moved = lstg.CompactObjectPool()
+    assert(moved > 0)
+    assert(lstg.CompactObjectPool() == 0)
+
+    -- 序号按更新顺序从 0 开始连续分配，对象 table 和更新顺序不变
+    local after = collect(-1)
+    assert(#after == #before)
+    for i, obj in ipairs(after) do
+        assert(rawequal(obj, before[i]))
+        assert(obj[2] == i - 1)
+        assert(obj.x == xs[i])
+        assert(lstg.IsValid(obj))
+        if lstg.ObjView then
+            local view, uid = lstg.ObjView(obj)
+            assert(uid == uids[i])
+            assert(view.x == obj.x)
+        end
+    end
+    for group = 0, 2 do
+        local list = collect(group)
+        assert(#list == #before_group[group])
+        for i, obj in ipairs(list) do
+            assert(rawequal(obj, before_group[group][i]))
+        end
+    end
+    for _, obj in ipairs(deleted) do
+        assert(not lstg.IsValid(obj))
+    end
+    assert(lstg.GetnObj() == 11)
+
+    -- 新对象接在整理后的对象之后
+    local obj = lstg.New(object_class)
+    assert(obj[2] == 11)
+
+    lstg.Print("test.Module.CompactObjectPool: passed")
+end
+
+function M:onDestroy()
+    lstg.ResetPool()
+end
+
+test.registerTest("test.Module.CompactObjectPool", M)
@@ -0,0 +1,62 @@
+local test = require("test")
+
+local object_class = {
+    function() end,
+    function() end,
+    function() end,
+    function() end,
+    function() end,
+    function() end;
+    is_class = true,
+}
+
+---@class test.Module.ObjectTableRecycling : test.Base
+local M = {}
+
+function M:onCreate()
+    lstg.ResetPool()
+    lstg.SetObjectTableRecycling(true, 16)
+
+    local obj = lstg.New(object_class)
+    local uid = rawget(obj, 5)
+    assert(type(uid) == "number")
+    assert(lstg.IsValid(obj))
+    assert(lstg.IsValid(obj, uid))
+    if lstg.ObjView then
+        local view, view_uid = lstg.ObjView(obj)
+        assert(view_uid == uid)
+        assert(lstg.IsObjViewValid(view, view_uid))
+    end
+
+    -- 回收后 table 被清空，旧的引用无效
+    lstg.Del(obj)
+    lstg.AfterFrame()
+    assert(not lstg.IsValid(obj))
+    assert(not lstg.IsValid(obj, uid))
+
+    -- table 被新对象复用，旧的引用指向新对象，只能通过 uid 识别
+    local obj2 = lstg.New(object_class)
+    assert(rawequal(obj, obj2))
+    local uid2 = rawget(obj2, 5)
+    assert(uid2 ~= uid)
+    assert(lstg.IsValid(obj2))
+    assert(lstg.IsValid(obj2, uid2))
+    assert(not lstg.IsValid(obj, uid))
+    if lstg.ObjView then
+        local _, view_uid = lstg.ObjView(obj2)
+        assert(view_uid == uid2)
+    end
+
+    -- 非法的 uid 参数
+    assert(not lstg.IsValid(obj2, "uid"))
+    assert(not lstg.IsValid(obj2, {}))
+
+    lstg.Print("test.Module.ObjectTableRecycling: passed")
+end
+
+function M:onDestroy()
+    lstg.ResetPool()
+    lstg.SetObjectTableRecycling(false)
+end
+
+test.registerTest("test.Module.ObjectTableRecycling", M)
@@ -0,0 +1,50 @@
+local test = require("test")
+
+local object_class = {
+    function() end,
+    function() end,
+    function() end,
+    function() end,
+    function() end,
+    function() end;
+    is_class = true,
+}
+
+---@class test.Module.ObjectView : test.Base
+local M = {}
+
+function M:onCreate()
+    lstg.ResetPool()
+    if not lstg.ObjView then
+        lstg.Log(3, "lstg.ObjView is not available (ffi not found)")
+        return
+    end
+
+    local obj = lstg.New(object_class)
+    obj.x = 12
+    obj.y = 34
+    local view, uid = lstg.ObjView(obj)
+    assert(view.x == 12 and view.y == 34)
+    assert(lstg.IsObjViewValid(view, uid))
+
+    -- 删除并回收后，保存下来的视图失效，再次获取视图时报错而不是解引用空指针
+    lstg.Del(obj)
+    lstg.AfterFrame()
+    assert(not lstg.IsObjViewValid(view, uid))
+    local ok = pcall(lstg.ObjView, obj)
+    assert(not ok)
+
+    -- 重置对象池同样会回收对象
+    local obj2 = lstg.New(object_class)
+    lstg.ResetPool()
+    ok = pcall(lstg.ObjView, obj2)
+    assert(not ok)
+
+    lstg.Print("test.Module.ObjectView: passed")
+end
+
+function M:onDestroy()
+    lstg.ResetPool()
+end
+
+test.registerTest("test.Module.ObjectView", M)
@@ -0,0 +1,159 @@
+local test = require("test")
+
+local object_class = {
+    function() end,
+    function() end,
+    function(self)
+        self.frames = self.frames + 1
+    end,
+    function() end,
+    function() end,
+    function() end;
+    is_class = true,
+}
+
+---@param group integer
+---@return table[]
+local function collect(group)
+    local list = {}
+    for _, obj in lstg.ObjWalk(group) do
+        list[#list + 1] = obj
+    end
+    return list
+end
+
+---@param list table[]
+local function record(list)
+    local states = {}
+    for i, obj in ipairs(list) do
+        states[i] = {
+            tag = obj.tag,
+            x = obj.x,
+            y = obj.y,
+            vx = obj.vx,
+            layer = obj.layer,
+            group = obj.group,
+            timer = obj.timer,
+            frames = obj.frames,
+        }
+    end
+    return states
+end
+
+---@param list table[]
+---@param states table[]
+local function compare(list, states)
+    assert(#list == #states)
+    for i, obj in ipairs(list) do
+        local s = states[i]
+        assert(obj.tag == s.tag)
+        assert(obj.x == s.x and obj.y == s.y)
+        assert(obj.vx == s.vx)
+        assert(obj.layer == s.layer)
+        assert(obj.group == s.group)
+        assert(obj.timer == s.timer)
+        assert(obj.frames == s.frames)
+        assert(lstg.IsValid(obj))
+    end
+end
+
+local function step()
+    lstg.ObjFrame()
+    lstg.AfterFrame()
+end
+
+---@class test.Module.ObjectSnapshot : test.Base
+local M = {}
+
+function M:onCreate()
+    lstg.ResetPool()
+
+    local objects = {}
+    for i = 1, 12 do
+        local obj = lstg.New(object_class)
+        obj.tag = i
+        obj.frames = 0
+        obj.x = i * 8
+        obj.y = -i * 4
+        obj.vx = i % 4
+        obj.layer = i % 5
+        obj.group = i % 3
+        objects[i] = obj
+    end
+    for _ = 1, 3 do
+        step()
+    end
+    -- 在场景中途留下空槽位
+    lstg.Del(objects[2])
+    lstg.Del(objects[7])
+    lstg.AfterFrame()
+    step()
+
+    local before = record(collect(-1))
+    local before_group = {}
+    for group = 0, 2 do
+        before_group[group] = record(collect(group))
+    end
+    assert(#before == 10)
+
+    local snap = lstg.ObjSnapshot(function(obj)
+        return { tag = obj.tag, frames = obj.frames }
+    end)
+
+    -- 修改场景：继续推进、删除、新建、换组
+    for _ = 1, 5 do
+        step()
+    end
+    lstg.Del(objects[1])
+    lstg.Del(objects[10])
+    for i = 1, 4 do
+        local obj = lstg.New(object_class)
+        obj.tag = 100 + i
+        obj.frames = 0
+        obj.x = -i
+    end
+    objects[3].group = 0
+    objects[5].x = 1000
+    lstg.AfterFrame()
+    step()
+    assert(lstg.GetnObj() == 12)
+
+    local count = lstg.ObjRestore(snap, function(obj, value)
+        obj.tag = value.tag
+        obj.frames = value.frames
+    end)
+    assert(count == 10)
+    assert(lstg.GetnObj() == 10)
+
+    -- 恢复后按更新顺序、组顺序比较；对象 table 是重建的，旧引用失效
+    compare(collect(-1), before)
+    for group = 0, 2 do
+        compare(collect(group), before_group[group])
+    end
+    for _, obj in ipairs(objects) do
+        assert(not lstg.IsValid(obj))
+    end
+
+    -- 恢复后继续推进，结果与快照时的状态一致
+    step()
+    for i, obj in ipairs(collect(-1)) do
+        assert(obj.timer == before[i].timer + 1)
+        assert(obj.frames == before[i].frames + 1)
+        assert(obj.x == before[i].x + before[i].vx)
+    end
+
+    -- 快照可以重复恢复
+    assert(lstg.ObjRestore(snap, function(obj, value)
+        obj.tag = value.tag
+        obj.frames = value.frames
+    end) == 10)
+    compare(collect(-1), before)
+
+    lstg.Print("test.Module.ObjectSnapshot: passed")
+end
+
+function M:onDestroy()
+    lstg.ResetPool()
+end
+
+test.registerTest("test.Module.ObjectSnapshot", M)
@@ -35,6 +35,7 @@ local lstg_GameObject = {
         -- render
         E("layer" , "LAYER" ),
         E("hide"  , "HIDE"  ),
+        E("nocull", "NOCULL"),
         E("img"   , "IMG"   ),
         E("rc"    , "RES_RC"),
         E("ani"   , "ANI"   ),
@@ -51,6 +52,7 @@ local lstg_GameObject = {
         E("a"     , "A"     ),
         E("b"     , "B"     ),
         E("rect"  , "RECT"  ),
+        E("swept" , "SWEPT" ),
         E("collider", "COLLIDER"), -- TODO: remove it
         -- TODO: fuck ex+
         E("_angle", "VANGLE"  ),